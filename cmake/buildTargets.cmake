@@ -24,7 +24,9 @@ if(BUILD_TESTING)
             test_rvine_structure
             test_serialization
             test_tools_bobyqa
+            test_tools_io
             test_tools_stats
+            test_tools_thread
             test_vinecop_class
             test_vinecop_sanity_checks
             test_weights
@@ -0,0 +1,63 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+// Loading a data set of 10^6 observations in 5 dimensions.
+//
+// The data are read from a text file (sequentially and in parallel) and
+// from vinecopulib's binary format, which is mapped into memory without
+// parsing or copying.
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vinecopulib.hpp>
+#include <vinecopulib/misc/tools_io.hpp>
+
+using namespace vinecopulib;
+
+template<class F>
+double
+time(const F& f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int
+main()
+{
+  size_t n = 1000000;
+  size_t d = 5;
+  size_t num_threads = 4;
+  auto u = tools_stats::simulate_uniform(n, d, false, { 1 });
+  std::ofstream("data_io.txt") << u.format(Eigen::IOFormat(17, 0, " "));
+  tools_io::write_binary("data_io.bin", u);
+
+  double sum = 0.0;
+  auto t_seq = time([&] { sum += tools_io::read_csv("data_io.txt").sum(); });
+  auto t_par = time(
+    [&] { sum += tools_io::read_csv("data_io.txt", num_threads).sum(); });
+  auto t_bin = time([&] {
+    tools_io::MappedData mapped("data_io.bin");
+    sum += mapped.get_data().sum();
+  });
+  // use the result so that the computation can't be optimized away
+  if (sum < 0) {
+    std::cout << "unexpected result" << std::endl;
+  }
+  std::cout << "text, 1 thread:             " << t_seq << "s" << std::endl;
+  std::cout << "text, " << num_threads << " threads:            " << t_par
+            << "s" << std::endl;
+  std::cout << "binary (memory-mapped):     " << t_bin << "s" << std::endl;
+
+  std::remove("data_io.txt");
+  std::remove("data_io.bin");
+  return 0;
+}
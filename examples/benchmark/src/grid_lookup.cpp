@@ -0,0 +1,64 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+// Throughput of grid lookups in `InterpolationGrid` on 10^7 points.
+//
+// The first grid is the Gaussian-quantile grid used by kernel estimators,
+// for which points are located through a table of equally sized buckets.
+// The second grid has a tiny first cell, so that the table would be too large
+// and binary search is used instead.
+
+#include <chrono>
+#include <iostream>
+#include <vinecopulib.hpp>
+
+using namespace vinecopulib;
+using tools_interpolation::InterpolationGrid;
+
+double
+points_per_second(InterpolationGrid& grid, const Eigen::MatrixXd& u)
+{
+  auto start = std::chrono::steady_clock::now();
+  Eigen::VectorXd values = grid.interpolate(u);
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  // use the result so that the computation can't be optimized away
+  if (values.sum() < 0) {
+    std::cout << "unexpected result" << std::endl;
+  }
+  return static_cast<double>(u.rows()) / elapsed.count();
+}
+
+int
+main()
+{
+  size_t n = 10000000;
+  size_t m = 30;
+  auto u = tools_stats::simulate_uniform(n, 2, false, { 1 });
+  Eigen::MatrixXd values = Eigen::MatrixXd::Constant(m, m, 1.0);
+
+  Eigen::VectorXd normal_grid(m);
+  for (size_t i = 0; i < m; ++i) {
+    normal_grid(i) =
+      -3.25 + static_cast<double>(i) * (6.5 / static_cast<double>(m - 1));
+  }
+  normal_grid = tools_stats::pnorm(normal_grid);
+  normal_grid(0) = 0.0;
+  normal_grid(m - 1) = 1.0;
+
+  Eigen::VectorXd uneven_grid = Eigen::VectorXd::LinSpaced(m, 0.0, 1.0);
+  uneven_grid(1) = 1e-8;
+
+  InterpolationGrid grid_table(normal_grid, values, 0);
+  InterpolationGrid grid_binary(uneven_grid, values, 0);
+  std::cout << "interpolate() on " << n << " points" << std::endl;
+  std::cout << "Gaussian-quantile grid (table):  "
+            << points_per_second(grid_table, u) << " points/s" << std::endl;
+  std::cout << "uneven grid (binary search):     "
+            << points_per_second(grid_binary, u) << " points/s" << std::endl;
+
+  return 0;
+}
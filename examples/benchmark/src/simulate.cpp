@@ -0,0 +1,90 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+// Simulation throughput for families without closed-form inverse h-functions.
+//
+// For each family, the inverse h-function is computed
+//   * by 35 steps of vectorized bisection on `hfunc1()` (the method used by
+//     vinecopulib <= 0.5.x), and
+//   * by `Bicop::hinv1()`,
+// and the number of points per second is reported. The last row reports the
+// simulation throughput of a 10-dimensional D-vine built from these families.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vinecopulib.hpp>
+
+using namespace vinecopulib;
+
+template<class F>
+double
+points_per_second(F f, size_t n)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return static_cast<double>(n) / elapsed.count();
+}
+
+int
+main()
+{
+  size_t n = 100000;
+  auto u = tools_stats::simulate_uniform(n, 2, false, { 1 });
+
+  FitControlsBicop controls({ BicopFamily::tll });
+  std::vector<Bicop> pcs = {
+    Bicop(BicopFamily::frank, 0, Eigen::VectorXd::Constant(1, 8.0)),
+    Bicop(BicopFamily::bb1, 0, Eigen::Vector2d(0.5, 1.5)),
+    Bicop(BicopFamily::bb6, 0, Eigen::Vector2d(1.5, 1.5)),
+    Bicop(BicopFamily::bb7, 0, Eigen::Vector2d(1.5, 0.5)),
+    Bicop(BicopFamily::bb8, 0, Eigen::Vector2d(3.0, 0.7))
+  };
+  pcs.push_back(Bicop(pcs[1].simulate(1000, false, { 2 }), controls));
+
+  std::cout << std::setw(30) << std::left << "family" << std::setw(15)
+            << std::right << "bisection/s" << std::setw(15) << "hinv1/s"
+            << std::setw(10) << "speedup" << std::setw(12) << "max diff"
+            << std::endl;
+  for (auto& pc : pcs) {
+    Eigen::VectorXd x_bisect, x_hinv;
+    double pps_bisect = points_per_second(
+      [&] {
+        Eigen::MatrixXd u_new = u;
+        auto h1 = [&](const Eigen::VectorXd& v) {
+          u_new.col(1) = v;
+          return pc.hfunc1(u_new);
+        };
+        x_bisect = tools_eigen::invert_f(u.col(1), h1);
+      },
+      n);
+    double pps_hinv = points_per_second([&] { x_hinv = pc.hinv1(u); }, n);
+    std::cout << std::setw(30) << std::left
+              << get_family_name(pc.get_family()) << std::setw(15)
+              << std::right << std::setprecision(3) << pps_bisect
+              << std::setw(15) << pps_hinv << std::setw(10)
+              << pps_hinv / pps_bisect << std::setw(12)
+              << (x_hinv - x_bisect).cwiseAbs().maxCoeff() << std::endl;
+  }
+
+  size_t d = 10;
+  auto pair_copulas = Vinecop::make_pair_copula_store(d);
+  for (size_t t = 0; t < d - 1; ++t) {
+    for (size_t e = 0; e < d - t - 1; ++e) {
+      pair_copulas[t][e] = pcs[(t + e) % pcs.size()];
+    }
+  }
+  Vinecop vc(DVineStructure(tools_stl::seq_int(1, d)), pair_copulas);
+  size_t n_sim = 10000;
+  double pps_sim =
+    points_per_second([&] { vc.simulate(n_sim, false, 1, { 3 }); }, n_sim);
+  std::cout << "Vinecop::simulate (d = " << d << "): " << pps_sim
+            << " samples/s" << std::endl;
+
+  return 0;
+}
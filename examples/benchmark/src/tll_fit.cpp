@@ -0,0 +1,74 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+// Speed and accuracy of binned fits for the TLL family.
+//
+// For each sample size and method, a TLL copula is fit with the exact
+// local-likelihood estimator and with the binned estimator (see
+// `FitControlsBicop::set_nonparametric_binned()`). The table reports the
+// fitting times, the maximal relative difference of the fitted densities on
+// a grid, and the difference of the log-likelihoods. The exact estimator is
+// skipped for the largest sample size.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vinecopulib.hpp>
+
+using namespace vinecopulib;
+
+double
+seconds_to_fit(Bicop& bicop,
+               const Eigen::MatrixXd& u,
+               const FitControlsBicop& controls)
+{
+  auto start = std::chrono::steady_clock::now();
+  bicop.fit(u, controls);
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+int
+main()
+{
+  Bicop model(BicopFamily::bb1, 0, Eigen::Vector2d(0.5, 1.5));
+  auto grid =
+    tools_eigen::expand_grid(Eigen::VectorXd::LinSpaced(50, 0.01, 0.99));
+
+  std::cout << std::setw(10) << "n" << std::setw(11) << "method"
+            << std::setw(12) << "exact (s)" << std::setw(13) << "binned (s)"
+            << std::setw(14) << "max rel diff" << std::setw(14)
+            << "loglik diff" << std::endl;
+  for (size_t n : { 1000, 10000, 100000, 1000000 }) {
+    auto u = model.simulate(n, false, { 1 });
+    for (auto method : { "constant", "linear", "quadratic" }) {
+      FitControlsBicop controls({ BicopFamily::tll }, "mle", method);
+      Bicop exact(BicopFamily::tll), binned(BicopFamily::tll);
+      controls.set_nonparametric_binned(true);
+      double time_binned = seconds_to_fit(binned, u, controls);
+      std::cout << std::setw(10) << n << std::setw(11) << method;
+      if (n < 1000000) {
+        controls.set_nonparametric_binned(false);
+        double time_exact = seconds_to_fit(exact, u, controls);
+        Eigen::VectorXd pdf_exact = exact.pdf(grid);
+        double rel_diff = ((binned.pdf(grid) - pdf_exact).array().abs() /
+                           pdf_exact.array())
+                            .maxCoeff();
+        std::cout << std::setw(12) << std::setprecision(3) << time_exact
+                  << std::setw(13) << time_binned << std::setw(14) << rel_diff
+                  << std::setw(14) << binned.get_loglik() - exact.get_loglik();
+      } else {
+        std::cout << std::setw(12) << "-" << std::setw(13)
+                  << std::setprecision(3) << time_binned << std::setw(14)
+                  << "-" << std::setw(14) << "-";
+      }
+      std::cout << std::endl;
+    }
+  }
+
+  return 0;
+}
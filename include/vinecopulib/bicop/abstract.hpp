@@ -10,6 +10,7 @@
 
 #include <Eigen/Dense>
 #include <vinecopulib/bicop/family.hpp>
+#include <vinecopulib/misc/var_types.hpp>
 
 namespace vinecopulib {
 //! @brief An abstract class for bivariate copula families.
@@ -30,6 +31,8 @@ protected:
     BicopFamily family = BicopFamily::indep,
     const Eigen::MatrixXd& parameters = Eigen::MatrixXd());
 
+  virtual std::shared_ptr<AbstractBicop> clone() const;
+
   // Getters and setters
   BicopFamily get_family() const;
 
@@ -39,7 +42,7 @@ protected:
 
   void set_loglik(const double loglik = NAN);
 
-  void set_var_types(const std::vector<std::string>& var_types);
+  void set_var_types(VarTypePair var_types);
 
   virtual Eigen::MatrixXd get_parameters() const = 0;
 
@@ -53,7 +56,9 @@ protected:
   virtual void fit(const Eigen::MatrixXd& data,
                    std::string method,
                    double mult,
-                   const Eigen::VectorXd& weights) = 0;
+                   const Eigen::VectorXd& weights,
+                   bool binned,
+                   double tau) = 0;
 
   virtual double get_npars() = 0;
 
@@ -64,6 +69,8 @@ protected:
   // following are virtual so they can be overriden by KernelBicop
   virtual Eigen::VectorXd pdf(const Eigen::MatrixXd& u);
 
+  Eigen::VectorXd logpdf(const Eigen::MatrixXd& u);
+
   virtual Eigen::VectorXd cdf(const Eigen::MatrixXd& u) = 0;
 
   virtual Eigen::VectorXd hfunc1(const Eigen::MatrixXd& u);
@@ -74,8 +81,22 @@ protected:
 
   Eigen::VectorXd hinv2(const Eigen::MatrixXd& u);
 
+  void evaluate(const Eigen::MatrixXd& u,
+                Eigen::VectorXd* pdf,
+                Eigen::VectorXd* hfunc1,
+                Eigen::VectorXd* hfunc2,
+                bool log_pdf = false);
+
+  virtual void evaluate_raw(const Eigen::MatrixXd& u,
+                            Eigen::VectorXd* pdf,
+                            Eigen::VectorXd* hfunc1,
+                            Eigen::VectorXd* hfunc2,
+                            bool log_pdf);
+
   virtual Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u) = 0;
 
+  virtual Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u);
+
   virtual Eigen::VectorXd hfunc1_raw(const Eigen::MatrixXd& u) = 0;
 
   virtual Eigen::VectorXd hfunc2_raw(const Eigen::MatrixXd& u) = 0;
@@ -92,6 +113,8 @@ protected:
 
   Eigen::VectorXd hinv2_num(const Eigen::MatrixXd& u);
 
+  Eigen::VectorXd hinv_newton(const Eigen::MatrixXd& u, size_t cond);
+
   Eigen::VectorXd pdf_c_d(const Eigen::MatrixXd& u);
 
   Eigen::VectorXd pdf_d_d(const Eigen::MatrixXd& u);
@@ -102,7 +125,7 @@ protected:
   // Data members
   BicopFamily family_;
   double loglik_{ NAN };
-  std::vector<std::string> var_types_{ "c", "c" };
+  VarTypePair var_types_{ VarTypePair::cc };
 };
 
 //! A shared pointer to an object of class AbstracBicop.
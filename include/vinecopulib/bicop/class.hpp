@@ -8,6 +8,7 @@
 
 #include <boost/property_tree/ptree.hpp>
 #include <vinecopulib/bicop/fit_controls.hpp>
+#include <vinecopulib/misc/var_types.hpp>
 
 namespace vinecopulib {
 
@@ -15,12 +16,20 @@ namespace vinecopulib {
 class AbstractBicop;
 using BicopPtr = std::shared_ptr<AbstractBicop>;
 
+// forward declarations of classes setting variable types internally
+class Vinecop;
+namespace tools_select {
+class VinecopSelector;
+}
+
 //! @brief A class for bivariate copula models.
 //!
 //! The copula model is fully characterized by the family, rotation,
 //! and parameters.
 class Bicop
 {
+  friend class Vinecop;
+  friend class tools_select::VinecopSelector;
 
 public:
   // Constructors
@@ -64,6 +73,7 @@ public:
   double get_aic() const;
   double get_bic() const;
   double get_mbic(const double psi0 = 0.9) const;
+  size_t get_num_saved_fits() const;
 
   void set_rotation(const int rotation);
 
@@ -76,6 +86,8 @@ public:
   // Stats methods
   Eigen::VectorXd pdf(const Eigen::MatrixXd& u) const;
 
+  Eigen::VectorXd logpdf(const Eigen::MatrixXd& u) const;
+
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u) const;
 
   Eigen::VectorXd hfunc1(const Eigen::MatrixXd& u) const;
@@ -86,6 +98,34 @@ public:
 
   Eigen::VectorXd hinv2(const Eigen::MatrixXd& u) const;
 
+  // Stats methods writing into caller-provided storage
+  void pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+           Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+              Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void hfunc1(const Eigen::Ref<const Eigen::MatrixXd>& u,
+              Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void hfunc2(const Eigen::Ref<const Eigen::MatrixXd>& u,
+              Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void hinv1(const Eigen::Ref<const Eigen::MatrixXd>& u,
+             Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void hinv2(const Eigen::Ref<const Eigen::MatrixXd>& u,
+             Eigen::Ref<Eigen::VectorXd> out) const;
+
+  void evaluate(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                Eigen::Ref<Eigen::VectorXd> pdf,
+                Eigen::Ref<Eigen::VectorXd> hfunc1,
+                Eigen::Ref<Eigen::VectorXd> hfunc2,
+                bool want_pdf = true,
+                bool want_hfunc1 = true,
+                bool want_hfunc2 = true,
+                bool log_pdf = false) const;
+
   Eigen::MatrixXd simulate(
     const size_t& n,
     const bool qrng = false,
@@ -124,22 +164,45 @@ public:
   Bicop as_continuous() const;
 
 private:
+  void fit(const Eigen::MatrixXd& data,
+           const FitControlsBicop& controls,
+           double tau);
+
+  void select(const Eigen::MatrixXd& data,
+              FitControlsBicop controls,
+              double tau);
+
   Eigen::MatrixXd format_data(const Eigen::MatrixXd& u) const;
 
   void rotate_data(Eigen::MatrixXd& u) const;
 
   Eigen::MatrixXd prep_for_abstract(const Eigen::MatrixXd& u) const;
 
+  const Eigen::MatrixXd& prep_for_abstract(
+    const Eigen::Ref<const Eigen::MatrixXd>& u,
+    Eigen::MatrixXd& u_new) const;
+
+  static Eigen::MatrixXd& get_workspace();
+
   void check_rotation(int rotation) const;
 
-  void check_data(const Eigen::MatrixXd& u) const;
+  void check_data(const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+
+  void check_data_dim(const Eigen::Ref<const Eigen::MatrixXd>& u) const;
 
-  void check_data_dim(const Eigen::MatrixXd& u) const;
+  void check_output_size(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                         const Eigen::Ref<const Eigen::VectorXd>& out) const;
 
   void check_var_types(const std::vector<std::string>& var_types) const;
 
+  void set_var_type_pair(VarTypePair var_types);
+
+  VarTypePair get_var_type_pair() const;
+
   void flip_abstract_var_types();
 
+  void detach_bicop();
+
   void check_weights_size(const Eigen::VectorXd& weights,
                           const Eigen::MatrixXd& data) const;
 
@@ -154,7 +217,8 @@ private:
   BicopPtr bicop_;
   int rotation_{ 0 };
   size_t nobs_{ 0 };
-  mutable std::vector<std::string> var_types_;
+  size_t num_saved_fits_{ 0 };
+  VarTypePair var_types_{ VarTypePair::cc };
 };
 }
 
@@ -41,12 +41,16 @@ public:
 
   double get_nonparametric_mult() const;
 
+  bool get_nonparametric_binned() const;
+
   std::string get_selection_criterion() const;
 
   Eigen::VectorXd get_weights() const;
 
   bool get_preselect_families() const;
 
+  bool get_racing() const;
+
   double get_psi0() const;
 
   size_t get_num_threads() const;
@@ -60,12 +64,16 @@ public:
 
   void set_nonparametric_mult(double nonparametric_mult);
 
+  void set_nonparametric_binned(bool nonparametric_binned);
+
   void set_selection_criterion(std::string selection_criterion);
 
   void set_weights(const Eigen::VectorXd& weights);
 
   void set_preselect_families(bool preselect_families);
 
+  void set_racing(bool racing);
+
   void set_psi0(double psi0);
 
   void set_num_threads(size_t num_threads);
@@ -81,9 +89,11 @@ private:
   std::string parametric_method_;
   std::string nonparametric_method_;
   double nonparametric_mult_;
+  bool nonparametric_binned_{ false };
   std::string selection_criterion_;
   Eigen::VectorXd weights_;
   bool preselect_families_;
+  bool racing_{ false };
   double psi0_;
   size_t num_threads_;
 
@@ -36,6 +36,15 @@ private:
   // pdf
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u);
 
+  // log-density and its derivative with respect to the parameter
+  Eigen::MatrixXd score_raw(const Eigen::MatrixXd& u) override;
+
+  // log-density
+  Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u) override;
+
+  // inverse hfunction
+  Eigen::VectorXd hinv1_raw(const Eigen::MatrixXd& u);
+
   // link between Kendall's tau and the par_bicop parameter
   Eigen::MatrixXd tau_to_parameters(const double& tau);
 
@@ -27,6 +27,12 @@ private:
   // PDF
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u);
 
+  // log-density and its derivative with respect to the parameter
+  Eigen::MatrixXd score_raw(const Eigen::MatrixXd& u) override;
+
+  // log-density
+  Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u) override;
+
   // CDF
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u);
 
@@ -36,6 +42,13 @@ private:
   // inverse hfunction
   Eigen::VectorXd hinv1_raw(const Eigen::MatrixXd& u);
 
+  // PDF and hfunctions from a single quantile transform
+  void evaluate_raw(const Eigen::MatrixXd& u,
+                    Eigen::VectorXd* pdf,
+                    Eigen::VectorXd* hfunc1,
+                    Eigen::VectorXd* hfunc2,
+                    bool log_pdf) override;
+
   Eigen::MatrixXd tau_to_parameters(const double& tau);
 
   Eigen::VectorXd get_start_parameters(const double tau);
@@ -87,6 +87,19 @@ AbstractBicop::create(BicopFamily family, const Eigen::MatrixXd& parameters)
 
 //!@}
 
+//! Creates an independent copy of the object.
+//!
+//! @return A pointer to a new object with the same family, parameters,
+//!     log-likelihood, and variable types.
+inline BicopPtr
+AbstractBicop::clone() const
+{
+  auto new_bicop = create(family_, get_parameters());
+  new_bicop->loglik_ = loglik_;
+  new_bicop->var_types_ = var_types_;
+  return new_bicop;
+}
+
 inline Eigen::MatrixXd
 AbstractBicop::no_tau_to_parameters(const double&)
 {
@@ -120,11 +133,8 @@ AbstractBicop::set_loglik(const double loglik)
 }
 
 inline void
-AbstractBicop::set_var_types(const std::vector<std::string>& var_types)
+AbstractBicop::set_var_types(VarTypePair var_types)
 {
-  if (var_types.size() != 2) {
-    throw std::runtime_error("var_types must have size two.");
-  }
   var_types_ = var_types;
 }
 //! @}
@@ -136,9 +146,9 @@ AbstractBicop::pdf(const Eigen::MatrixXd& u)
 {
 
   Eigen::VectorXd pdf(u.rows());
-  if (var_types_ == std::vector<std::string>{ "c", "c" }) {
+  if (var_types_ == VarTypePair::cc) {
     pdf = pdf_raw(u.leftCols(2));
-  } else if (var_types_ == std::vector<std::string>{ "d", "d" }) {
+  } else if (var_types_ == VarTypePair::dd) {
     pdf = pdf_d_d(u);
   } else {
     pdf = pdf_c_d(u);
@@ -147,10 +157,36 @@ AbstractBicop::pdf(const Eigen::MatrixXd& u)
   return pdf;
 }
 
+//! evaluates the logarithm of the pdf, truncated to the logarithms of
+//! DBL_MIN and DBL_MAX (so that it agrees with `log(pdf(u))`).
+//! @param u Matrix of evaluation points.
+inline Eigen::VectorXd
+AbstractBicop::logpdf(const Eigen::MatrixXd& u)
+{
+  Eigen::VectorXd logpdf(u.rows());
+  if (var_types_ == VarTypePair::cc) {
+    logpdf = logpdf_raw(u.leftCols(2));
+    tools_eigen::trim(logpdf, std::log(DBL_MIN), std::log(DBL_MAX));
+  } else {
+    logpdf = this->pdf(u).array().log();
+  }
+  return logpdf;
+}
+
+//! evaluates the logarithm of the pdf for continuous variables; the default
+//! takes the logarithm of `pdf_raw()`, families with a closed-form
+//! log-density override it.
+//! @param u \f$m \times 2\f$ matrix of evaluation points.
+inline Eigen::VectorXd
+AbstractBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  return pdf_raw(u).array().log();
+}
+
 inline Eigen::VectorXd
 AbstractBicop::pdf_c_d(const Eigen::MatrixXd& u)
 {
-  if (var_types_[0] != "c") {
+  if (is_discrete(var_types_, 0)) {
     return (hfunc2_raw(u.leftCols(2)) - hfunc2_raw(u.rightCols(2)))
       .cwiseQuotient(u.col(0) - u.col(2))
       .cwiseAbs();
@@ -177,7 +213,7 @@ AbstractBicop::pdf_d_d(const Eigen::MatrixXd& u)
 inline Eigen::VectorXd
 AbstractBicop::hfunc1(const Eigen::MatrixXd& u)
 {
-  if (var_types_[0] == "d") {
+  if (is_discrete(var_types_, 0)) {
     auto uu = u;
     uu.col(3) = uu.col(1);
     return ((cdf(uu.leftCols(2)) - cdf(uu.rightCols(2))).array() /
@@ -191,7 +227,7 @@ AbstractBicop::hfunc1(const Eigen::MatrixXd& u)
 inline Eigen::VectorXd
 AbstractBicop::hfunc2(const Eigen::MatrixXd& u)
 {
-  if (var_types_[1] == "d") {
+  if (is_discrete(var_types_, 1)) {
     auto uu = u;
     uu.col(2) = uu.col(0);
     return ((cdf(uu.leftCols(2)) - cdf(uu.rightCols(2))).array() /
@@ -205,7 +241,7 @@ AbstractBicop::hfunc2(const Eigen::MatrixXd& u)
 inline Eigen::VectorXd
 AbstractBicop::hinv1(const Eigen::MatrixXd& u)
 {
-  if (var_types_[0] == "c") {
+  if (!is_discrete(var_types_, 0)) {
     return hinv1_raw(u.leftCols(2));
   } else {
     return hinv1_num(u);
@@ -215,31 +251,108 @@ AbstractBicop::hinv1(const Eigen::MatrixXd& u)
 inline Eigen::VectorXd
 AbstractBicop::hinv2(const Eigen::MatrixXd& u)
 {
-  if (var_types_[1] == "c") {
+  if (!is_discrete(var_types_, 1)) {
     return hinv2_raw(u.leftCols(2));
   } else {
     return hinv2_num(u);
   }
 }
 
+//! evaluates the density and the h-functions at the same points.
+//!
+//! For continuous variables, the computations are delegated to
+//! `evaluate_raw()`, which allows families to share intermediate results;
+//! otherwise, `pdf()`, `hfunc1()`, and `hfunc2()` are called.
+//! @param u Matrix of evaluation points.
+//! @param pdf Pointer to a vector that will contain the density (not
+//!   evaluated if `nullptr`).
+//! @param hfunc1 Pointer to a vector that will contain the first h-function
+//!   (not evaluated if `nullptr`).
+//! @param hfunc2 Pointer to a vector that will contain the second h-function
+//!   (not evaluated if `nullptr`).
+//! @param log_pdf Whether `pdf` should contain the log-density instead.
+inline void
+AbstractBicop::evaluate(const Eigen::MatrixXd& u,
+                        Eigen::VectorXd* pdf,
+                        Eigen::VectorXd* hfunc1,
+                        Eigen::VectorXd* hfunc2,
+                        bool log_pdf)
+{
+  if (var_types_ == VarTypePair::cc) {
+    evaluate_raw(u.leftCols(2), pdf, hfunc1, hfunc2, log_pdf);
+    if (pdf && log_pdf) {
+      tools_eigen::trim(*pdf, std::log(DBL_MIN), std::log(DBL_MAX));
+    } else if (pdf) {
+      tools_eigen::trim(*pdf, DBL_MIN, DBL_MAX);
+    }
+    return;
+  }
+  if (pdf) {
+    *pdf = log_pdf ? this->logpdf(u) : this->pdf(u);
+  }
+  if (hfunc1) {
+    *hfunc1 = this->hfunc1(u);
+  }
+  if (hfunc2) {
+    *hfunc2 = this->hfunc2(u);
+  }
+}
+
+//! evaluates the density and the h-functions for continuous variables.
+//!
+//! The default calls `pdf_raw()` (or `logpdf_raw()`), `hfunc1_raw()`, and
+//! `hfunc2_raw()`; families whose functions share expensive transformations
+//! of the data override it to compute them only once.
+//! @param u \f$m \times 2\f$ matrix of evaluation points.
+//! @param pdf see `evaluate()`.
+//! @param hfunc1 see `evaluate()`.
+//! @param hfunc2 see `evaluate()`.
+//! @param log_pdf see `evaluate()`.
+inline void
+AbstractBicop::evaluate_raw(const Eigen::MatrixXd& u,
+                            Eigen::VectorXd* pdf,
+                            Eigen::VectorXd* hfunc1,
+                            Eigen::VectorXd* hfunc2,
+                            bool log_pdf)
+{
+  if (pdf) {
+    *pdf = log_pdf ? logpdf_raw(u) : pdf_raw(u);
+  }
+  if (hfunc1) {
+    *hfunc1 = hfunc1_raw(u);
+  }
+  if (hfunc2) {
+    *hfunc2 = hfunc2_raw(u);
+  }
+}
+
 //! evaluates the log-likelihood.
 //! @param u Data matrix.
 //! @param weights Optional weights for each observation.
 inline double
 AbstractBicop::loglik(const Eigen::MatrixXd& u, const Eigen::VectorXd weights)
 {
-  Eigen::MatrixXd log_pdf = this->pdf(u).array().log();
-  if (weights.size() > 0) {
-    log_pdf = log_pdf.cwiseProduct(weights);
+  Eigen::VectorXd logpdf = this->logpdf(u);
+  bool weighted = (weights.size() > 0);
+  double loglik = 0.0;
+  for (Eigen::Index i = 0; i < logpdf.size(); ++i) {
+    double log_f = logpdf(i);
+    if (weighted) {
+      log_f *= weights(i);
+    }
+    if (!std::isnan(log_f)) {
+      loglik += log_f;
+    }
   }
-  tools_eigen::remove_nans(log_pdf);
-  return log_pdf.sum();
+  return loglik;
 }
 
 //! Numerical inversion of h-functions
 //!
 //! These are generic functions to invert the hfunctions numerically.
 //! They can be used in derived classes to define \c hinv1 and \c hinv2.
+//! When the conditioning variable is continuous, the h-functions are
+//! inverted by `hinv_newton()`; otherwise, a bisection method is used.
 //!
 //! @param u \f$m \times 2\f$ matrix of evaluation points.
 //! @return The numerical inverse of h-functions.
@@ -247,6 +360,9 @@ AbstractBicop::loglik(const Eigen::MatrixXd& u, const Eigen::VectorXd weights)
 inline Eigen::VectorXd
 AbstractBicop::hinv1_num(const Eigen::MatrixXd& u)
 {
+  if (!is_discrete(var_types_, 0)) {
+    return hinv_newton(u.leftCols(2), 0);
+  }
   Eigen::MatrixXd u_new = u;
   auto h1 = [&](const Eigen::VectorXd& v) {
     u_new.col(1) = v;
@@ -259,6 +375,9 @@ AbstractBicop::hinv1_num(const Eigen::MatrixXd& u)
 inline Eigen::VectorXd
 AbstractBicop::hinv2_num(const Eigen::MatrixXd& u)
 {
+  if (!is_discrete(var_types_, 1)) {
+    return hinv_newton(u.leftCols(2), 1);
+  }
   Eigen::MatrixXd u_new = u;
   auto h1 = [&](const Eigen::VectorXd& x) {
     u_new.col(0) = x;
@@ -268,4 +387,90 @@ AbstractBicop::hinv2_num(const Eigen::MatrixXd& u)
   return tools_eigen::invert_f(u.col(0), h1);
 }
 //! @}
+
+//! Inversion of h-functions by safeguarded Newton iterations
+//!
+//! The derivative of an h-function with respect to its free argument is the
+//! copula density, so each iteration costs one call to `evaluate_raw()`
+//! for both, restricted to the points that have not converged yet. Each point
+//! keeps a bracket containing the root; Newton steps leaving the bracket or
+//! failing to halve the previous step are replaced by bisection steps.
+//!
+//! @param u \f$m \times 2\f$ matrix of evaluation points.
+//! @param cond The column of the conditioning variable (0 for the inverse
+//!   of `hfunc1()`, 1 for the inverse of `hfunc2()`).
+inline Eigen::VectorXd
+AbstractBicop::hinv_newton(const Eigen::MatrixXd& u, size_t cond)
+{
+  const size_t free = 1 - cond;
+  const size_t max_iter = 50;
+  const double tol = 1e-12;
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  size_t n = static_cast<size_t>(u.rows());
+
+  // start at the solution under independence
+  Eigen::VectorXd x = u.col(free);
+  Eigen::VectorXd xl = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd xh = Eigen::VectorXd::Ones(n);
+  Eigen::VectorXd dx_old = Eigen::VectorXd::Ones(n);
+  std::vector<size_t> active;
+  active.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    if ((boost::math::isnan)(u(i, 0)) || (boost::math::isnan)(u(i, 1))) {
+      x(i) = nan;
+    } else {
+      active.push_back(i);
+    }
+  }
+
+  Eigen::MatrixXd u_act;
+  for (size_t iter = 0; (iter < max_iter) && !active.empty(); ++iter) {
+    size_t m = active.size();
+    u_act.resize(m, 2);
+    for (size_t k = 0; k < m; ++k) {
+      u_act(k, cond) = u(active[k], cond);
+      u_act(k, free) = x(active[k]);
+    }
+    Eigen::VectorXd h, f;
+    Eigen::VectorXd* h1 = (cond == 0) ? &h : nullptr;
+    Eigen::VectorXd* h2 = (cond == 1) ? &h : nullptr;
+    evaluate_raw(u_act, &f, h1, h2, false);
+
+    size_t n_active = 0;
+    for (size_t k = 0; k < m; ++k) {
+      size_t i = active[k];
+      double fx = h(k) - u(i, free);
+      if ((boost::math::isnan)(fx)) {
+        if (iter == 0) {
+          x(i) = nan;
+          continue;
+        }
+        fx = 1.0; // move towards the lower end, as in `invert_f()`
+      } else if (fx == 0.0) {
+        continue;
+      }
+      if (fx < 0) {
+        xl(i) = x(i);
+      } else {
+        xh(i) = x(i);
+      }
+
+      double dx = fx / f(k);
+      double x_new = x(i) - dx;
+      if (!std::isfinite(x_new) || (x_new <= xl(i)) || (x_new >= xh(i)) ||
+          (std::fabs(dx) > 0.5 * std::fabs(dx_old(i)))) {
+        x_new = (xl(i) + xh(i)) / 2.0;
+        dx = x(i) - x_new;
+      }
+      dx_old(i) = dx;
+      x(i) = x_new;
+      if ((std::fabs(dx) > tol) && (xh(i) - xl(i) > tol)) {
+        active[n_active++] = i;
+      }
+    }
+    active.resize(n_active);
+  }
+
+  return x;
+}
 }
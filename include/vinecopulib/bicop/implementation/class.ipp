@@ -11,6 +11,7 @@
 #include <vinecopulib/misc/tools_serialization.hpp>
 #include <vinecopulib/misc/tools_stats.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
+#include <wdm/eigen.hpp>
 
 //! Tools for bivariate and vine copula modeling
 namespace vinecopulib {
@@ -56,20 +57,22 @@ inline Bicop::Bicop(const Eigen::MatrixXd& data,
   select(data, controls);
 }
 
-//! @brief Copy constructor (deep copy)
+//! @brief Copy constructor
+//!
+//! The copy shares the underlying model with `other` until one of them is
+//! modified (copy-on-write), so copying is cheap even for nonparametric
+//! families.
 //!
 //! @param other Bicop object to copy.
 inline Bicop::Bicop(const Bicop& other)
-  : Bicop(other.get_family(),
-          other.get_rotation(),
-          other.get_parameters(),
-          other.get_var_types())
-{
-  nobs_ = other.nobs_;
-  bicop_->set_loglik(other.bicop_->get_loglik());
-}
+  : bicop_(other.bicop_)
+  , rotation_(other.rotation_)
+  , nobs_(other.nobs_)
+  , num_saved_fits_(other.num_saved_fits_)
+  , var_types_(other.var_types_)
+{}
 
-//! @brief Copy assignment operator (deep copy)
+//! @brief Copy assignment operator (see the copy constructor)
 //!
 //! @param other Bicop object to copy.
 inline Bicop&
@@ -79,6 +82,7 @@ Bicop::operator=(Bicop other)
   std::swap(bicop_, other.bicop_);
   std::swap(rotation_, other.rotation_);
   std::swap(nobs_, other.nobs_);
+  std::swap(num_saved_fits_, other.num_saved_fits_);
   std::swap(var_types_, other.var_types_);
   return *this;
 }
@@ -94,8 +98,8 @@ inline Bicop::Bicop(const boost::property_tree::ptree input)
 {
   // try block for backwards compatibility
   try {
-    var_types_ = tools_serialization::ptree_to_vector<std::string>(
-      input.get_child("var_types"));
+    set_var_types(tools_serialization::ptree_to_vector<std::string>(
+      input.get_child("var_types")));
     nobs_ = input.get<size_t>("nobs_");
     bicop_->set_loglik(input.get<double>("loglik"));
   } catch (...) {
@@ -134,7 +138,7 @@ Bicop::to_ptree() const
   auto mat_node = tools_serialization::matrix_to_ptree(get_parameters());
   output.add_child("parameters", mat_node);
   output.add_child("var_types",
-                   tools_serialization::vector_to_ptree(var_types_));
+                   tools_serialization::vector_to_ptree(get_var_types()));
 
   output.put("nobs_", nobs_);
   output.put("loglik", bicop_->get_loglik());
@@ -168,8 +172,27 @@ Bicop::to_json(const std::string& filename) const
 inline Eigen::VectorXd
 Bicop::pdf(const Eigen::MatrixXd& u) const
 {
-  check_data(u);
-  return bicop_->pdf(prep_for_abstract(u));
+  Eigen::VectorXd f(u.rows());
+  pdf(u, f);
+  return f;
+}
+
+//! @brief Evaluates the logarithm of the copula density.
+//!
+//! The log-density is computed directly (without taking the logarithm of
+//! `pdf()`) for the Gaussian, Student, Clayton, Gumbel, Frank, Joe, and
+//! independence families. It is truncated to the logarithms of the bounds
+//! used by `pdf()`.
+//!
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+//! @return The log-density evaluated at \c u.
+inline Eigen::VectorXd
+Bicop::logpdf(const Eigen::MatrixXd& u) const
+{
+  Eigen::VectorXd f(u.rows());
+  logpdf(u, f);
+  return f;
 }
 
 //! @brief Evaluates the copula distribution.
@@ -206,125 +229,319 @@ Bicop::cdf(const Eigen::MatrixXd& u) const
 inline Eigen::VectorXd
 Bicop::hfunc1(const Eigen::MatrixXd& u) const
 {
-  check_data(u);
   Eigen::VectorXd h(u.rows());
+  hfunc1(u, h);
+  return h;
+}
+
+//! @brief Evaluates the second h-function.
+//!
+//! The second h-function is
+//! \f$ h_2(u_1, u_2) = P(U_1 \le u_1 | U_2 = u_2)  \f$.
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+inline Eigen::VectorXd
+Bicop::hfunc2(const Eigen::MatrixXd& u) const
+{
+  Eigen::VectorXd h(u.rows());
+  hfunc2(u, h);
+  return h;
+}
+
+//! @brief Evaluates the inverse of the first h-function.
+//!
+//! The first h-function is
+//! \f$ h_1(u_1, u_2) = P(U_2 \le u_2 | U_1 = u_1) \f$.
+//! The inverse is calulated w.r.t. the second argument.
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+inline Eigen::VectorXd
+Bicop::hinv1(const Eigen::MatrixXd& u) const
+{
+  Eigen::VectorXd hi(u.rows());
+  hinv1(u, hi);
+  return hi;
+}
+
+//! @brief Evaluates the inverse of the second h-function.
+//!
+//! The second h-function is
+//! \f$ h_2(u_1, u_2) = P(U_1 \le u_1 | U_2 = u_2)  \f$.
+//! The inverse is calculated w.r.t. the first argument.
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+inline Eigen::VectorXd
+Bicop::hinv2(const Eigen::MatrixXd& u) const
+{
+  Eigen::VectorXd hi(u.rows());
+  hinv2(u, hi);
+  return hi;
+}
+//! @}
+
+//! @name Evaluation into caller-provided storage
+//!
+//! The following overloads behave like their counterparts above, but read
+//! the data through an `Eigen::Ref` (so that blocks and columns of larger
+//! matrices can be passed without copying) and write the result into `out`,
+//! which must have `u.rows()` elements. Formatting, trimming, and rotation of
+//! the data are done in a single pass into a thread-local buffer, so that
+//! repeated calls (e.g., from the edges of a vine) do not allocate
+//! temporaries for the input data.
+//! @{
+
+//! @brief Evaluates the copula density, see `pdf(const Eigen::MatrixXd&)`.
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+//! @param out A vector of size \f$ n \f$ the density is written to.
+inline void
+Bicop::pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+           Eigen::Ref<Eigen::VectorXd> out) const
+{
+  check_data(u);
+  check_output_size(u, out);
+  out = bicop_->pdf(prep_for_abstract(u, get_workspace()));
+}
+
+//! @brief Evaluates the logarithm of the copula density, see
+//! `logpdf(const Eigen::MatrixXd&)`.
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+//! @param out A vector of size \f$ n \f$ the log-density is written to.
+inline void
+Bicop::logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+              Eigen::Ref<Eigen::VectorXd> out) const
+{
+  check_data(u);
+  check_output_size(u, out);
+  out = bicop_->logpdf(prep_for_abstract(u, get_workspace()));
+}
+
+//! @brief Evaluates the first h-function, see
+//! `hfunc1(const Eigen::MatrixXd&)`.
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+//! @param out A vector of size \f$ n \f$ the h-function is written to.
+inline void
+Bicop::hfunc1(const Eigen::Ref<const Eigen::MatrixXd>& u,
+              Eigen::Ref<Eigen::VectorXd> out) const
+{
+  check_data(u);
+  check_output_size(u, out);
+  const Eigen::MatrixXd& u_new = prep_for_abstract(u, get_workspace());
   switch (rotation_) {
     default:
-      h = bicop_->hfunc1(prep_for_abstract(u));
+      out = bicop_->hfunc1(u_new);
       break;
 
     case 90:
-      h = bicop_->hfunc2(prep_for_abstract(u));
+      out = bicop_->hfunc2(u_new);
       break;
 
     case 180:
-      h = 1.0 - bicop_->hfunc1(prep_for_abstract(u)).array();
+      out = 1.0 - bicop_->hfunc1(u_new).array();
       break;
 
     case 270:
-      h = 1.0 - bicop_->hfunc2(prep_for_abstract(u)).array();
+      out = 1.0 - bicop_->hfunc2(u_new).array();
       break;
   }
-  tools_eigen::trim(h, 0.0, 1.0);
-  return h;
+  tools_eigen::trim(out, 0.0, 1.0);
 }
 
-//! @brief Evaluates the second h-function.
-//!
-//! The second h-function is
-//! \f$ h_2(u_1, u_2) = P(U_1 \le u_1 | U_2 = u_2)  \f$.
+//! @brief Evaluates the second h-function, see
+//! `hfunc2(const Eigen::MatrixXd&)`.
 //! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
 //!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
-inline Eigen::VectorXd
-Bicop::hfunc2(const Eigen::MatrixXd& u) const
+//! @param out A vector of size \f$ n \f$ the h-function is written to.
+inline void
+Bicop::hfunc2(const Eigen::Ref<const Eigen::MatrixXd>& u,
+              Eigen::Ref<Eigen::VectorXd> out) const
 {
   check_data(u);
-  Eigen::VectorXd h(u.rows());
+  check_output_size(u, out);
+  const Eigen::MatrixXd& u_new = prep_for_abstract(u, get_workspace());
   switch (rotation_) {
     default:
-      h = bicop_->hfunc2(prep_for_abstract(u));
+      out = bicop_->hfunc2(u_new);
       break;
 
     case 90:
-      h = 1.0 - bicop_->hfunc1(prep_for_abstract(u)).array();
+      out = 1.0 - bicop_->hfunc1(u_new).array();
       break;
 
     case 180:
-      h = 1.0 - bicop_->hfunc2(prep_for_abstract(u)).array();
+      out = 1.0 - bicop_->hfunc2(u_new).array();
       break;
 
     case 270:
-      h = bicop_->hfunc1(prep_for_abstract(u)).array();
+      out = bicop_->hfunc1(u_new);
       break;
   }
-  tools_eigen::trim(h, 0.0, 1.0);
-  return h;
+  tools_eigen::trim(out, 0.0, 1.0);
 }
 
-//! @brief Evaluates the inverse of the first h-function.
-//!
-//! The first h-function is
-//! \f$ h_1(u_1, u_2) = P(U_2 \le u_2 | U_1 = u_1) \f$.
-//! The inverse is calulated w.r.t. the second argument.
+//! @brief Evaluates the inverse of the first h-function, see
+//! `hinv1(const Eigen::MatrixXd&)`.
 //! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
 //!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
-inline Eigen::VectorXd
-Bicop::hinv1(const Eigen::MatrixXd& u) const
+//! @param out A vector of size \f$ n \f$ the inverse is written to.
+inline void
+Bicop::hinv1(const Eigen::Ref<const Eigen::MatrixXd>& u,
+             Eigen::Ref<Eigen::VectorXd> out) const
 {
   check_data(u);
-  Eigen::VectorXd hi(u.rows());
+  check_output_size(u, out);
+  const Eigen::MatrixXd& u_new = prep_for_abstract(u, get_workspace());
   switch (rotation_) {
     default:
-      hi = bicop_->hinv1(prep_for_abstract(u));
+      out = bicop_->hinv1(u_new);
       break;
 
     case 90:
-      hi = bicop_->hinv2(prep_for_abstract(u));
+      out = bicop_->hinv2(u_new);
       break;
 
     case 180:
-      hi = 1.0 - bicop_->hinv1(prep_for_abstract(u)).array();
+      out = 1.0 - bicop_->hinv1(u_new).array();
       break;
 
     case 270:
-      hi = 1.0 - bicop_->hinv2(prep_for_abstract(u)).array();
+      out = 1.0 - bicop_->hinv2(u_new).array();
       break;
   }
-  tools_eigen::trim(hi, 0.0, 1.0);
-  return hi;
+  tools_eigen::trim(out, 0.0, 1.0);
 }
 
-//! @brief Evaluates the inverse of the second h-function.
+//! @brief Evaluates the inverse of the second h-function, see
+//! `hinv2(const Eigen::MatrixXd&)`.
+//! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
+//!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
+//! @param out A vector of size \f$ n \f$ the inverse is written to.
+inline void
+Bicop::hinv2(const Eigen::Ref<const Eigen::MatrixXd>& u,
+             Eigen::Ref<Eigen::VectorXd> out) const
+{
+  check_data(u);
+  check_output_size(u, out);
+  const Eigen::MatrixXd& u_new = prep_for_abstract(u, get_workspace());
+  switch (rotation_) {
+    default:
+      out = bicop_->hinv2(u_new);
+      break;
+
+    case 90:
+      out = 1.0 - bicop_->hinv1(u_new).array();
+      break;
+
+    case 180:
+      out = 1.0 - bicop_->hinv2(u_new).array();
+      break;
+
+    case 270:
+      out = bicop_->hinv1(u_new);
+      break;
+  }
+  tools_eigen::trim(out, 0.0, 1.0);
+}
+
+//! @brief Evaluates the copula density and both h-functions at once.
 //!
-//! The second h-function is
-//! \f$ h_2(u_1, u_2) = P(U_1 \le u_1 | U_2 = u_2)  \f$.
-//! The inverse is calculated w.r.t. the first argument.
+//! The result is the same as calling `pdf()`, `hfunc1()`, and `hfunc2()`,
+//! but the data are checked and prepared only once, and families share
+//! intermediate results between the three functions (e.g., the quantile
+//! transforms of the Gaussian and Student families).
 //! @param u An \f$ n \times (2 + k) \f$ matrix of observations contained in
 //!   \f$(0, 1) \f$, where \f$ k \f$ is the number of discrete variables.
-inline Eigen::VectorXd
-Bicop::hinv2(const Eigen::MatrixXd& u) const
+//! @param pdf A vector of size \f$ n \f$ the density is written to.
+//! @param hfunc1 A vector of size \f$ n \f$ the first h-function is written
+//!   to.
+//! @param hfunc2 A vector of size \f$ n \f$ the second h-function is written
+//!   to.
+//! @param want_pdf Whether the density should be evaluated; if `false`,
+//!   `pdf` is left untouched (and may have any size).
+//! @param want_hfunc1 Whether the first h-function should be evaluated.
+//! @param want_hfunc2 Whether the second h-function should be evaluated.
+//! @param log_pdf Whether the logarithm of the density (see `logpdf()`)
+//!   should be written to `pdf`.
+inline void
+Bicop::evaluate(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                Eigen::Ref<Eigen::VectorXd> pdf,
+                Eigen::Ref<Eigen::VectorXd> hfunc1,
+                Eigen::Ref<Eigen::VectorXd> hfunc2,
+                bool want_pdf,
+                bool want_hfunc1,
+                bool want_hfunc2,
+                bool log_pdf) const
 {
   check_data(u);
-  Eigen::VectorXd hi(u.rows());
+  if (want_pdf) {
+    check_output_size(u, pdf);
+  }
+  if (want_hfunc1) {
+    check_output_size(u, hfunc1);
+  }
+  if (want_hfunc2) {
+    check_output_size(u, hfunc2);
+  }
+
+  // h-functions of the rotated model that are required
+  bool swap = (rotation_ == 90) || (rotation_ == 270);
+  bool want_h1_rot = swap ? want_hfunc2 : want_hfunc1;
+  bool want_h2_rot = swap ? want_hfunc1 : want_hfunc2;
+  Eigen::VectorXd f, h1, h2;
+  bicop_->evaluate(prep_for_abstract(u, get_workspace()),
+                   want_pdf ? &f : nullptr,
+                   want_h1_rot ? &h1 : nullptr,
+                   want_h2_rot ? &h2 : nullptr,
+                   log_pdf);
+
+  if (want_pdf) {
+    pdf = f;
+  }
   switch (rotation_) {
     default:
-      hi = bicop_->hinv2(prep_for_abstract(u));
+      if (want_hfunc1) {
+        hfunc1 = h1;
+      }
+      if (want_hfunc2) {
+        hfunc2 = h2;
+      }
       break;
 
     case 90:
-      hi = 1.0 - bicop_->hinv1(prep_for_abstract(u)).array();
+      if (want_hfunc1) {
+        hfunc1 = h2;
+      }
+      if (want_hfunc2) {
+        hfunc2 = 1.0 - h1.array();
+      }
       break;
 
     case 180:
-      hi = 1.0 - bicop_->hinv2(prep_for_abstract(u)).array();
+      if (want_hfunc1) {
+        hfunc1 = 1.0 - h1.array();
+      }
+      if (want_hfunc2) {
+        hfunc2 = 1.0 - h2.array();
+      }
       break;
 
     case 270:
-      hi = bicop_->hinv1(prep_for_abstract(u));
+      if (want_hfunc1) {
+        hfunc1 = 1.0 - h2.array();
+      }
+      if (want_hfunc2) {
+        hfunc2 = h1;
+      }
       break;
   }
-  tools_eigen::trim(hi, 0.0, 1.0);
-  return hi;
+  if (want_hfunc1) {
+    tools_eigen::trim(hfunc1, 0.0, 1.0);
+  }
+  if (want_hfunc2) {
+    tools_eigen::trim(hfunc2, 0.0, 1.0);
+  }
 }
 //! @}
 
@@ -548,6 +765,15 @@ Bicop::get_mbic(const double psi0) const
   return -2 * bicop_->get_loglik() + compute_mbic_penalty(nobs_, psi0);
 }
 
+//! @brief Gets the number of candidate models that were not fit on the full
+//! data in the last call to `select()` because racing discarded them (see
+//! `FitControlsBicop::set_racing()`); zero if racing was not used.
+inline size_t
+Bicop::get_num_saved_fits() const
+{
+  return num_saved_fits_;
+}
+
 inline double
 Bicop::compute_mbic_penalty(const size_t nobs, const double psi0) const
 {
@@ -574,18 +800,32 @@ Bicop::set_rotation(const int rotation)
     flip_abstract_var_types();
   }
   rotation_ = rotation;
+  detach_bicop();
   bicop_->set_loglik();
 }
 
 inline void
-Bicop::check_data(const Eigen::MatrixXd& u) const
+Bicop::check_data(const Eigen::Ref<const Eigen::MatrixXd>& u) const
 {
   check_data_dim(u);
   tools_eigen::check_if_in_unit_cube(u);
 }
 
+//! @brief Checks whether an output vector matches the number of observations.
+inline void
+Bicop::check_output_size(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                         const Eigen::Ref<const Eigen::VectorXd>& out) const
+{
+  if (out.size() != u.rows()) {
+    std::stringstream msg;
+    msg << "output has wrong size; "
+        << "expected: " << u.rows() << ", actual: " << out.size() << std::endl;
+    throw std::runtime_error(msg.str());
+  }
+}
+
 inline void
-Bicop::check_data_dim(const Eigen::MatrixXd& u) const
+Bicop::check_data_dim(const Eigen::Ref<const Eigen::MatrixXd>& u) const
 {
   size_t n_cols = u.cols();
   int n_disc = get_n_discrete();
@@ -609,12 +849,24 @@ Bicop::check_data_dim(const Eigen::MatrixXd& u) const
 inline void
 Bicop::flip_abstract_var_types()
 {
-  std::swap(bicop_->var_types_[0], bicop_->var_types_[1]);
+  detach_bicop();
+  bicop_->var_types_ = flip_var_types(bicop_->var_types_);
+}
+
+//! @brief Clones the underlying model if it is shared with other Bicop
+//! objects; must be called before the model is modified.
+inline void
+Bicop::detach_bicop()
+{
+  if (bicop_.use_count() > 1) {
+    bicop_ = bicop_->clone();
+  }
 }
 
 inline void
 Bicop::set_parameters(const Eigen::MatrixXd& parameters)
 {
+  detach_bicop();
   bicop_->set_parameters(parameters);
   bicop_->set_loglik();
 }
@@ -626,20 +878,14 @@ inline void
 Bicop::set_var_types(const std::vector<std::string>& var_types)
 {
   check_var_types(var_types);
-  var_types_ = var_types;
-  if (bicop_) {
-    bicop_->set_var_types(var_types);
-    if (tools_stl::is_member(static_cast<size_t>(rotation_), { 90, 270 })) {
-      flip_abstract_var_types();
-    }
-  }
+  set_var_type_pair(vinecopulib::get_var_type_pair(var_types));
 }
 
 //! @brief Gets variable types.
 inline std::vector<std::string>
 Bicop::get_var_types() const
 {
-  return var_types_;
+  return get_var_type_names(var_types_);
 }
 //! @}
 
@@ -666,7 +912,7 @@ Bicop::flip()
     bicop_->flip();
   }
   // change Bicop-level var_types
-  std::swap(var_types_[0], var_types_[1]);
+  var_types_ = flip_var_types(var_types_);
 }
 
 //! @brief Summarizes the model into a string (can be used for printing).
@@ -711,11 +957,10 @@ Bicop::get_bicop() const
 inline Bicop
 Bicop::as_continuous() const
 {
-  std::vector<std::string> cc = { "c", "c" };
-  if (var_types_ == cc)
+  if (var_types_ == VarTypePair::cc)
     return *this;
   auto bc_new = *this;
-  bc_new.set_var_types(cc);
+  bc_new.set_var_type_pair(VarTypePair::cc);
   return bc_new;
 }
 
@@ -743,6 +988,20 @@ Bicop::as_continuous() const
 //! @param controls The controls (see FitControlsBicop).
 inline void
 Bicop::fit(const Eigen::MatrixXd& data, const FitControlsBicop& controls)
+{
+  fit(data, controls, NAN);
+}
+
+//! @brief Fits a bivariate copula (see `fit()`) when Kendall's \f$ \tau \f$
+//! of the data is already known.
+//! @param data The data.
+//! @param controls The controls.
+//! @param tau Kendall's \f$ \tau \f$ of the data without missing values
+//!   (computed if NaN).
+inline void
+Bicop::fit(const Eigen::MatrixXd& data,
+           const FitControlsBicop& controls,
+           double tau)
 {
   std::string method;
   if (tools_stl::is_member(bicop_->get_family(), bicop_families::parametric)) {
@@ -757,11 +1016,19 @@ Bicop::fit(const Eigen::MatrixXd& data, const FitControlsBicop& controls)
   check_weights_size(w, data);
   tools_eigen::remove_nans(data_no_nan, w);
 
+  // the abstract model sees the rotated data
+  if ((rotation_ == 90) || (rotation_ == 270)) {
+    tau = -tau;
+  }
+  detach_bicop();
   bicop_->fit(prep_for_abstract(data_no_nan),
               method,
               controls.get_nonparametric_mult(),
-              w);
+              w,
+              controls.get_nonparametric_binned(),
+              tau);
   nobs_ = data_no_nan.rows();
+  num_saved_fits_ = 0;
 }
 
 //
@@ -786,6 +1053,23 @@ Bicop::fit(const Eigen::MatrixXd& data, const FitControlsBicop& controls)
 //! @param controls The controls (see FitControlsBicop).
 inline void
 Bicop::select(const Eigen::MatrixXd& data, FitControlsBicop controls)
+{
+  select(data, controls, NAN);
+}
+
+//! @brief Selects the best fitting model (see `select()`) when Kendall's
+//! \f$ \tau \f$ of the data is already known.
+//!
+//! Kendall's \f$ \tau \f$ is computed only once and shared by all
+//! candidate fits.
+//! @param data The data.
+//! @param controls The controls.
+//! @param tau Kendall's \f$ \tau \f$ of the data without missing values
+//!   (computed if NaN).
+inline void
+Bicop::select(const Eigen::MatrixXd& data,
+              FitControlsBicop controls,
+              double tau)
 {
   using namespace tools_select;
   check_weights_size(controls.get_weights(), data);
@@ -797,6 +1081,7 @@ Bicop::select(const Eigen::MatrixXd& data, FitControlsBicop controls)
   }
   check_data(data_no_nan);
   nobs_ = data_no_nan.rows();
+  num_saved_fits_ = 0;
 
   bicop_ = AbstractBicop::create();
   bicop_->set_var_types(var_types_);
@@ -804,62 +1089,66 @@ Bicop::select(const Eigen::MatrixXd& data, FitControlsBicop controls)
   bicop_->set_loglik(0.0);
   if (data_no_nan.rows() >= 10) {
     tools_eigen::trim(data_no_nan);
-    std::vector<Bicop> bicops = create_candidate_bicops(data_no_nan, controls);
+    if (std::isnan(tau)) {
+      auto w = controls.get_weights();
+      tau = wdm::wdm(data_no_nan.leftCols(2), "tau", w)(0, 1);
+    }
+    std::vector<Bicop> bicops =
+      create_candidate_bicops(data_no_nan, controls, tau);
     for (auto& bc : bicops) {
-      bc.set_var_types(var_types_);
+      bc.set_var_type_pair(var_types_);
+    }
+    if (controls.get_racing()) {
+      size_t num_candidates = bicops.size();
+      race_candidates(bicops, data_no_nan, controls);
+      num_saved_fits_ = num_candidates - bicops.size();
     }
 
     // Estimate all models and select the best one using the
     // selection_criterion
     double fitted_criterion = std::numeric_limits<double>::max();
+    size_t fitted_index = bicops.size();
     std::mutex m;
-    auto fit_and_compare = [&](Bicop cop) {
+    auto fit_and_compare = [&](size_t index) {
       tools_interface::check_user_interrupt();
+      Bicop& cop = bicops[index];
       // Estimate the model
-      cop.fit(data_no_nan, controls);
+      cop.fit(data_no_nan, controls, tau);
 
       // Compute the selection criterion
-      double new_criterion;
-      double ll = cop.get_loglik();
-      if (controls.get_selection_criterion() == "loglik") {
-        new_criterion = -ll;
-      } else if (controls.get_selection_criterion() == "aic") {
-        new_criterion = -2 * ll + 2 * cop.get_npars();
-      } else {
-        double n_eff = static_cast<double>(data_no_nan.rows());
-        if (controls.get_weights().size() > 0) {
-          n_eff = std::pow(controls.get_weights().sum(), 2);
-          n_eff /= controls.get_weights().array().pow(2).sum();
-        }
-        double npars = cop.get_npars();
-
-        new_criterion = -2 * ll + log(n_eff) * npars; // BIC
-        if (controls.get_selection_criterion() == "mbic") {
-          // correction for mBIC
-          bool is_indep = (cop.get_family() == BicopFamily::indep);
-          double psi0 = controls.get_psi0();
-          double log_prior = static_cast<double>(!is_indep) * log(psi0) +
-                             static_cast<double>(is_indep) * log(1.0 - psi0);
-          new_criterion -= 2 * log_prior;
-        }
-      }
+      double new_criterion =
+        -2 * cop.get_loglik() + get_criterion_penalty(cop, nobs_, controls);
 
       // the following block modifies thread-external variables
       // and is thus shielded by a mutex
       {
         std::lock_guard<std::mutex> lk(m);
         // If the new model is better than the current one,
-        // then replace the current model by the new one
-        if (new_criterion < fitted_criterion) {
+        // then replace the current model by the new one (ties are broken
+        // by the order of candidates, independently of the fitting order)
+        if ((new_criterion < fitted_criterion) ||
+            ((new_criterion == fitted_criterion) && (index < fitted_index))) {
           fitted_criterion = new_criterion;
+          fitted_index = index;
           bicop_ = cop.get_bicop();
           rotation_ = cop.get_rotation();
         }
       }
     };
 
-    tools_thread::ThreadPool pool(controls.get_num_threads());
-    pool.map(fit_and_compare, bicops);
+    // expensive candidates are fit first, cheap ones fill the gaps at the end
+    std::vector<double> costs;
+    for (auto& bc : bicops) {
+      costs.push_back(get_fit_cost(bc.get_family(), controls));
+    }
+    auto fit_batch = [&](const std::vector<size_t>& batch) {
+      for (auto index : batch) {
+        fit_and_compare(index);
+      }
+    };
+    size_t num_threads = controls.get_num_threads();
+    tools_thread::ThreadPool pool(num_threads);
+    pool.map(fit_batch, tools_batch::create_batches(costs, num_threads));
   }
 }
 
@@ -878,7 +1167,7 @@ Bicop::format_data(const Eigen::MatrixXd& u) const
   // n_disc = 1:
   Eigen::MatrixXd u_new(u.rows(), 4);
   u_new.leftCols(2) = u.leftCols(2);
-  int disc_col = (var_types_[1] == "d");
+  int disc_col = is_discrete(var_types_, 1);
   int cont_col = 1 - disc_col;
   // We already know that there is one discrete and one continuous variable. Now
   // there are two cases:
@@ -940,6 +1229,77 @@ Bicop::prep_for_abstract(const Eigen::MatrixXd& u) const
   return u_new;
 }
 
+//! @brief Prepares data for use with the `AbstractBicop` class without
+//! temporaries.
+//!
+//! Does the same as `prep_for_abstract(const Eigen::MatrixXd&)`, but in a
+//! single pass over the data: column formatting and rotation are handled by
+//! remapping column indices and flipping values instead of copying and
+//! swapping columns.
+//!
+//! @param u The data.
+//! @param u_new The storage the prepared data is written to.
+//! @return A reference to `u_new`.
+inline const Eigen::MatrixXd&
+Bicop::prep_for_abstract(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                         Eigen::MatrixXd& u_new) const
+{
+  // source columns of the formatted data (see `format_data()`)
+  Eigen::Index cols[4] = { 0, 1, 2, 3 };
+  auto n_disc = get_n_discrete();
+  Eigen::Index n_cols = (n_disc == 0) ? 2 : 4;
+  if (n_disc == 1) {
+    int disc_col = is_discrete(var_types_, 1);
+    int cont_col = 1 - disc_col;
+    cols[2 + disc_col] = 2 + (u.cols() == 4) * disc_col;
+    cols[2 + cont_col] = cont_col;
+  }
+
+  // counter-clockwise rotations (see `rotate_data()`)
+  int from[4] = { 0, 1, 2, 3 };
+  bool flip[4] = { false, false, false, false };
+  switch (rotation_) {
+    case 90:
+      from[0] = 1, from[1] = 0, from[2] = 3, from[3] = 2;
+      flip[1] = flip[3] = true;
+      break;
+
+    case 180:
+      flip[0] = flip[1] = flip[2] = flip[3] = true;
+      break;
+
+    case 270:
+      from[0] = 1, from[1] = 0, from[2] = 3, from[3] = 2;
+      flip[0] = flip[2] = true;
+      break;
+  }
+
+  // resizing is a no-op if the size hasn't changed
+  Eigen::Index n = u.rows();
+  u_new.resize(n, n_cols);
+  for (Eigen::Index j = 0; j < n_cols; ++j) {
+    auto col_in = u.col(cols[from[j]]);
+    auto col_out = u_new.col(j);
+    for (Eigen::Index i = 0; i < n; ++i) {
+      // trim to [1e-10, 1 - 1e-10] before rotating (see `tools_eigen::trim()`)
+      double x = col_in(i);
+      if (!std::isnan(x)) {
+        x = std::min(std::max(x, 1e-10), 1 - 1e-10);
+      }
+      col_out(i) = flip[j] ? 1.0 - x : x;
+    }
+  }
+  return u_new;
+}
+
+//! @brief Returns a thread-local buffer for preparing data.
+inline Eigen::MatrixXd&
+Bicop::get_workspace()
+{
+  static thread_local Eigen::MatrixXd workspace;
+  return workspace;
+}
+
 //! @brief Checks whether the supplied rotation is valid (only 0, 90, 180, 270
 //! allowd).
 inline void
@@ -993,14 +1353,31 @@ Bicop::check_var_types(const std::vector<std::string>& var_types) const
   }
 }
 
+//! @brief Sets the variable types without checks (see `set_var_types()`).
+inline void
+Bicop::set_var_type_pair(VarTypePair var_types)
+{
+  var_types_ = var_types;
+  if (bicop_) {
+    detach_bicop();
+    bicop_->set_var_types(var_types);
+    if ((rotation_ == 90) | (rotation_ == 270)) {
+      flip_abstract_var_types();
+    }
+  }
+}
+
+//! @brief Gets the variable types in their internal representation.
+inline VarTypePair
+Bicop::get_var_type_pair() const
+{
+  return var_types_;
+}
+
 //! @brief Returns the number of discrete variables.
 inline unsigned short
 Bicop::get_n_discrete() const
 {
-  int n_discrete = 0;
-  for (auto t : var_types_) {
-    n_discrete += (t == "d");
-  }
-  return static_cast<unsigned short>(n_discrete);
+  return count_discrete(var_types_);
 }
 }
@@ -64,6 +64,46 @@ ClaytonBicop::pdf_raw(const Eigen::MatrixXd& u)
   return tools_eigen::binaryExpr_or_nan(u, f);
 }
 
+inline Eigen::MatrixXd
+ClaytonBicop::score_raw(const Eigen::MatrixXd& u)
+{
+  double theta = static_cast<double>(parameters_(0));
+  Eigen::MatrixXd score(u.rows(), 2);
+  for (Eigen::Index i = 0; i < u.rows(); ++i) {
+    double log_u1 = std::log(u(i, 0));
+    double log_u2 = std::log(u(i, 1));
+    double t1 = std::exp(-theta * log_u1);
+    double t2 = std::exp(-theta * log_u2);
+    double a = t1 + t2 - 1.0;
+    double da = -t1 * log_u1 - t2 * log_u2;
+    double log_a = std::log(a);
+    score(i, 0) = boost::math::log1p(theta) -
+                  (1.0 + theta) * (log_u1 + log_u2) -
+                  (2.0 + 1.0 / theta) * log_a;
+    score(i, 1) = 1.0 / (1.0 + theta) - (log_u1 + log_u2) +
+                  log_a / (theta * theta) - (2.0 + 1.0 / theta) * da / a;
+  }
+  return score;
+}
+
+inline Eigen::VectorXd
+ClaytonBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  double theta = static_cast<double>(parameters_(0));
+  // avoid numerical issues when copula is too close to independence
+  if (theta < 1e-10) {
+    auto f = [](const double&, const double&) { return 0.0; };
+    return tools_eigen::binaryExpr_or_nan(u, f);
+  }
+
+  auto f = [theta](const double& u1, const double& u2) {
+    double temp = boost::math::log1p(theta) - (1.0 + theta) * std::log(u1 * u2);
+    return temp - (2.0 + 1.0 / (theta)) *
+                    std::log(std::pow(u1, -theta) + std::pow(u2, -theta) - 1.0);
+  };
+  return tools_eigen::binaryExpr_or_nan(u, f);
+}
+
 inline Eigen::VectorXd
 ClaytonBicop::hinv1_raw(const Eigen::MatrixXd& u)
 {
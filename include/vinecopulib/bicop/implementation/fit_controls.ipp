@@ -155,6 +155,13 @@ FitControlsBicop::get_nonparametric_mult() const
   return nonparametric_mult_;
 }
 
+//! returns whether the nonparametric family is fit on binned data.
+inline bool
+FitControlsBicop::get_nonparametric_binned() const
+{
+  return nonparametric_binned_;
+}
+
 //! returns the number of threads.
 inline size_t
 FitControlsBicop::get_num_threads() const
@@ -182,6 +189,13 @@ FitControlsBicop::get_preselect_families() const
   return preselect_families_;
 }
 
+//! returns whether candidate families are raced on subsamples.
+inline bool
+FitControlsBicop::get_racing() const
+{
+  return racing_;
+}
+
 //! returns the baseline probability for mBIC selection.
 inline double
 FitControlsBicop::get_psi0() const
@@ -220,6 +234,20 @@ FitControlsBicop::set_nonparametric_mult(double nonparametric_mult)
   nonparametric_mult_ = nonparametric_mult;
 }
 
+//! Sets whether the nonparametric family (TLL) is fit on binned data.
+//!
+//! With binning, the observations are linearly binned on a fine grid and the
+//! local-likelihood estimator is computed by a discrete convolution. The cost
+//! is linear in the number of observations (instead of proportional to the
+//! number of observations times the number of grid points), at the price of
+//! a small approximation error. The default (`false`) uses the exact
+//! estimator.
+inline void
+FitControlsBicop::set_nonparametric_binned(bool nonparametric_binned)
+{
+  nonparametric_binned_ = nonparametric_binned;
+}
+
 //! Sets the selection criterion.
 inline void
 FitControlsBicop::set_selection_criterion(std::string selection_criterion)
@@ -243,6 +271,22 @@ FitControlsBicop::set_preselect_families(bool preselect_families)
   preselect_families_ = preselect_families;
 }
 
+//! Sets whether candidate families are raced on subsamples.
+//!
+//! With racing, `Bicop::select()` first fits all candidates on a random
+//! subsample of the data and discards those whose selection criterion
+//! (extrapolated to the full sample) is worse than the best one by more than
+//! three standard errors. The survivors are refit on subsamples four times
+//! as large until the subsample would exceed half of the data; only the
+//! remaining candidates are fit on the full data. Racing only applies to
+//! samples with at least 1000 observations. The default (`false`) fits all
+//! candidates on the full data.
+inline void
+FitControlsBicop::set_racing(bool racing)
+{
+  racing_ = racing;
+}
+
 //! Sets the prior probability for mBIC.
 inline void
 FitControlsBicop::set_psi0(double psi0)
@@ -300,6 +344,10 @@ FitControlsBicop::str_internal(bool print_threads) const
                << std::endl;
   controls_str << "Nonparametric multiplier: " << get_nonparametric_mult()
                << std::endl;
+  controls_str << "Nonparametric binning: "
+               << static_cast<std::string>(get_nonparametric_binned() ? "yes"
+                                                                      : "no")
+               << std::endl;
   controls_str << "Weights: "
                << static_cast<std::string>(get_weights().size() == 0 ? "no"
                                                                      : "yes")
@@ -310,6 +358,9 @@ FitControlsBicop::str_internal(bool print_threads) const
                << static_cast<std::string>(get_preselect_families() ? "yes"
                                                                     : "no")
                << std::endl;
+  controls_str << "Racing: "
+               << static_cast<std::string>(get_racing() ? "yes" : "no")
+               << std::endl;
   controls_str << "mBIC prior probability: " << get_psi0() << std::endl;
   if (print_threads) {
     controls_str << "Number of threads: "
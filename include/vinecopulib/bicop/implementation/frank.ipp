@@ -65,6 +65,61 @@ FrankBicop::pdf_raw(const Eigen::MatrixXd& u)
   return tools_eigen::binaryExpr_or_nan(u, f);
 }
 
+inline Eigen::MatrixXd
+FrankBicop::score_raw(const Eigen::MatrixXd& u)
+{
+  // with E = exp(-theta), E_j = exp(-theta * u_j), the density is
+  // theta (1 - E) E_1 E_2 / D^2, where D = (1 - E) - (1 - E_1) (1 - E_2)
+  double theta = static_cast<double>(parameters_(0));
+  double em1 = -boost::math::expm1(-theta);
+  double log_c = std::log(theta * em1);
+  double dlog_c = 1.0 / theta + 1.0 / boost::math::expm1(theta);
+  Eigen::MatrixXd score(u.rows(), 2);
+  for (Eigen::Index i = 0; i < u.rows(); ++i) {
+    double u1 = u(i, 0);
+    double u2 = u(i, 1);
+    double em1_1 = -boost::math::expm1(-theta * u1);
+    double em1_2 = -boost::math::expm1(-theta * u2);
+    double d = em1 - em1_1 * em1_2;
+    double dd = (1.0 - em1) - u1 * (1.0 - em1_1) * em1_2 -
+                u2 * (1.0 - em1_2) * em1_1;
+    score(i, 0) = log_c - theta * (u1 + u2) - 2.0 * std::log(std::fabs(d));
+    score(i, 1) = dlog_c - (u1 + u2) - 2.0 * dd / d;
+  }
+  return score;
+}
+
+inline Eigen::VectorXd
+FrankBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  // with E = exp(-theta), E_j = exp(-theta * u_j), the density is
+  // theta (1 - E) E_1 E_2 / D^2, where D = (1 - E) - (1 - E_1) (1 - E_2)
+  double theta = static_cast<double>(parameters_(0));
+  double em1 = -boost::math::expm1(-theta);
+  double log_c = std::log(theta * em1);
+  auto f = [theta, em1, log_c](const double& u1, const double& u2) {
+    double d = em1 - boost::math::expm1(-theta * u1) *
+                       boost::math::expm1(-theta * u2);
+    return log_c - theta * (u1 + u2) - 2.0 * std::log(std::fabs(d));
+  };
+  return tools_eigen::binaryExpr_or_nan(u, f);
+}
+
+inline Eigen::VectorXd
+FrankBicop::hinv1_raw(const Eigen::MatrixXd& u)
+{
+  double theta = static_cast<double>(parameters_(0));
+  if (std::fabs(theta) < 1e-10) {
+    return u.col(1);
+  }
+  double em1 = boost::math::expm1(-theta);
+  auto f = [theta, em1](const double& u1, const double& u2) {
+    double a = std::exp(-theta * u1);
+    return -boost::math::log1p(u2 * em1 / (u2 + a * (1 - u2))) / theta;
+  };
+  return tools_eigen::binaryExpr_or_nan(u, f);
+}
+
 inline Eigen::MatrixXd
 FrankBicop::tau_to_parameters(const double& tau)
 {
@@ -18,23 +18,35 @@ inline GaussianBicop::GaussianBicop()
   parameters_upper_bounds_ << 1;
 }
 
-inline Eigen::VectorXd GaussianBicop::pdf_raw(const Eigen::MatrixXd &u)
+inline Eigen::VectorXd
+GaussianBicop::pdf_raw(const Eigen::MatrixXd& u)
 {
-  // Inverse Cholesky of the correlation matrix
-  double rho = double(this->parameters_(0));
-  Eigen::Matrix2d L;
-  L(0, 0) = 1;
-  L(1, 1) = 1 / sqrt(1.0 - pow(rho, 2.0));
-  L(0, 1) = -rho * L(1, 1);
-  L(1, 0) = 0;
+  Eigen::VectorXd f;
+  evaluate_raw(u, &f, nullptr, nullptr, false);
+  return f;
+}
 
-  // Compute copula density
-  Eigen::VectorXd f = Eigen::VectorXd::Ones(u.rows());
+inline Eigen::MatrixXd
+GaussianBicop::score_raw(const Eigen::MatrixXd& u)
+{
+  double rho = double(this->parameters_(0));
+  double r2 = 1.0 - rho * rho;
   Eigen::MatrixXd tmp = tools_stats::qnorm(u);
-  f = f.cwiseQuotient(tools_stats::dnorm(tmp).rowwise().prod());
-  tmp = tmp * L;
-  f = f.cwiseProduct(tools_stats::dnorm(tmp).rowwise().prod());
-  return f / sqrt(1.0 - pow(rho, 2.0));
+  Eigen::ArrayXd sq = tmp.array().square().rowwise().sum();
+  Eigen::ArrayXd prod = tmp.col(0).cwiseProduct(tmp.col(1)).array();
+  Eigen::MatrixXd score(u.rows(), 2);
+  score.col(0) =
+    -0.5 * std::log(r2) - (rho * rho * sq - 2 * rho * prod) / (2 * r2);
+  score.col(1) = rho / r2 - (rho * sq - (1 + rho * rho) * prod) / (r2 * r2);
+  return score;
+}
+
+inline Eigen::VectorXd
+GaussianBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  Eigen::VectorXd f;
+  evaluate_raw(u, &f, nullptr, nullptr, true);
+  return f;
 }
 
 inline Eigen::VectorXd
@@ -47,11 +59,9 @@ GaussianBicop::cdf(const Eigen::MatrixXd& u)
 inline Eigen::VectorXd
 GaussianBicop::hfunc1_raw(const Eigen::MatrixXd& u)
 {
-  double rho = double(this->parameters_(0));
-  Eigen::VectorXd h = Eigen::VectorXd::Zero(u.rows());
-  Eigen::MatrixXd tmp = tools_stats::qnorm(u);
-  h = (tmp.col(1) - rho * tmp.col(0)) / sqrt(1.0 - pow(rho, 2.0));
-  return tools_stats::pnorm(h);
+  Eigen::VectorXd h;
+  evaluate_raw(u, nullptr, &h, nullptr, false);
+  return h;
 }
 
 inline Eigen::VectorXd
@@ -64,6 +74,44 @@ GaussianBicop::hinv1_raw(const Eigen::MatrixXd& u)
   return tools_stats::pnorm(hinv);
 }
 
+inline void
+GaussianBicop::evaluate_raw(const Eigen::MatrixXd& u,
+                            Eigen::VectorXd* pdf,
+                            Eigen::VectorXd* hfunc1,
+                            Eigen::VectorXd* hfunc2,
+                            bool log_pdf)
+{
+  double rho = double(this->parameters_(0));
+  Eigen::MatrixXd tmp = tools_stats::qnorm(u);
+  if (pdf && log_pdf) {
+    double r2 = 1.0 - rho * rho;
+    Eigen::ArrayXd sq = tmp.array().square().rowwise().sum();
+    Eigen::ArrayXd prod = tmp.col(0).cwiseProduct(tmp.col(1)).array();
+    *pdf = -0.5 * std::log(r2) - (rho * rho * sq - 2 * rho * prod) / (2 * r2);
+  } else if (pdf) {
+    // Inverse Cholesky of the correlation matrix
+    Eigen::Matrix2d L;
+    L(0, 0) = 1;
+    L(1, 1) = 1 / sqrt(1.0 - pow(rho, 2.0));
+    L(0, 1) = -rho * L(1, 1);
+    L(1, 0) = 0;
+
+    // Compute copula density
+    Eigen::VectorXd f = Eigen::VectorXd::Ones(u.rows());
+    f = f.cwiseQuotient(tools_stats::dnorm(tmp).rowwise().prod());
+    f = f.cwiseProduct(tools_stats::dnorm(tmp * L).rowwise().prod());
+    *pdf = f / sqrt(1.0 - pow(rho, 2.0));
+  }
+  if (hfunc1) {
+    Eigen::VectorXd h = tmp.col(1) - rho * tmp.col(0);
+    *hfunc1 = tools_stats::pnorm(h / sqrt(1.0 - pow(rho, 2.0)));
+  }
+  if (hfunc2) {
+    Eigen::VectorXd h = tmp.col(0) - rho * tmp.col(1);
+    *hfunc2 = tools_stats::pnorm(h / sqrt(1.0 - pow(rho, 2.0)));
+  }
+}
+
 inline Eigen::VectorXd
 GaussianBicop::get_start_parameters(const double tau)
 {
@@ -63,6 +63,48 @@ GumbelBicop::pdf_raw(const Eigen::MatrixXd& u)
   return tools_eigen::binaryExpr_or_nan(u, f);
 }
 
+inline Eigen::MatrixXd
+GumbelBicop::score_raw(const Eigen::MatrixXd& u)
+{
+  double theta = static_cast<double>(parameters_(0));
+  Eigen::MatrixXd score(u.rows(), 2);
+  for (Eigen::Index i = 0; i < u.rows(); ++i) {
+    double a = -std::log(u(i, 0));
+    double b = -std::log(u(i, 1));
+    double log_a = std::log(a);
+    double log_b = std::log(b);
+    double ta = std::pow(a, theta);
+    double tb = std::pow(b, theta);
+    double t1 = ta + tb;
+    double log_t1 = std::log(t1);
+    double dt1 = ta * log_a + tb * log_b;
+    double s = std::exp(log_t1 / theta);
+    double ds = s * (dt1 / (theta * t1) - log_t1 / (theta * theta));
+    score(i, 0) = -s + (2.0 / theta - 2.0) * log_t1 +
+                  (theta - 1.0) * (log_a + log_b) + a + b +
+                  boost::math::log1p((theta - 1.0) / s);
+    score(i, 1) = -ds - 2.0 * log_t1 / (theta * theta) +
+                  (2.0 / theta - 2.0) * dt1 / t1 + log_a + log_b +
+                  (s - (theta - 1.0) * ds) / (s * (s + theta - 1.0));
+  }
+  return score;
+}
+
+inline Eigen::VectorXd
+GumbelBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  double theta = static_cast<double>(parameters_(0));
+  double thetha1 = 1.0 / theta;
+  auto f = [theta, thetha1](const double& u1, const double& u2) {
+    double t1 = std::pow(-std::log(u1), theta) + std::pow(-std::log(u2), theta);
+    return -std::pow(t1, thetha1) + (2 * thetha1 - 2.0) * std::log(t1) +
+           (theta - 1.0) * std::log(std::log(u1) * std::log(u2)) -
+           std::log(u1 * u2) +
+           boost::math::log1p((theta - 1.0) * std::pow(t1, -thetha1));
+  };
+  return tools_eigen::binaryExpr_or_nan(u, f);
+}
+
 inline Eigen::VectorXd
 GumbelBicop::hinv1_raw(const Eigen::MatrixXd& u)
 {
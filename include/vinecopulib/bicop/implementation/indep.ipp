@@ -21,6 +21,13 @@ IndepBicop::pdf_raw(const Eigen::MatrixXd& u)
   return tools_eigen::binaryExpr_or_nan(u, f);
 }
 
+inline Eigen::VectorXd
+IndepBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  auto f = [](double, double) { return 0.0; };
+  return tools_eigen::binaryExpr_or_nan(u, f);
+}
+
 inline Eigen::VectorXd IndepBicop::cdf(const Eigen::MatrixXd &u)
 {
   return u.rowwise().prod();
@@ -63,6 +63,43 @@ inline Eigen::VectorXd JoeBicop::pdf_raw(const Eigen::MatrixXd &u)
   return tools_eigen::binaryExpr_or_nan(u, f);
 }
 
+inline Eigen::MatrixXd
+JoeBicop::score_raw(const Eigen::MatrixXd& u)
+{
+  double theta = static_cast<double>(parameters_(0));
+  Eigen::MatrixXd score(u.rows(), 2);
+  for (Eigen::Index i = 0; i < u.rows(); ++i) {
+    double l1 = boost::math::log1p(-u(i, 0));
+    double l2 = boost::math::log1p(-u(i, 1));
+    double t1 = std::exp(theta * l1);
+    double t2 = std::exp(theta * l2);
+    double s = t1 + t2 - t1 * t2;
+    double ds = t1 * l1 * (1.0 - t2) + t2 * l2 * (1.0 - t1);
+    double log_s = std::log(s);
+    score(i, 0) = (1.0 / theta - 2.0) * log_s + (theta - 1.0) * (l1 + l2) +
+                  std::log(theta - 1.0 + s);
+    score(i, 1) = -log_s / (theta * theta) + (1.0 / theta - 2.0) * ds / s +
+                  l1 + l2 + (1.0 + ds) / (theta - 1.0 + s);
+  }
+  return score;
+}
+
+inline Eigen::VectorXd
+JoeBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  double theta = static_cast<double>(parameters_(0));
+  auto f = [theta](const double& u1, const double& u2) {
+    double l1 = boost::math::log1p(-u1);
+    double l2 = boost::math::log1p(-u2);
+    double t1 = std::exp(theta * l1);
+    double t2 = std::exp(theta * l2);
+    double s = t1 + t2 - t1 * t2;
+    return (1.0 / theta - 2.0) * std::log(s) + (theta - 1.0) * (l1 + l2) +
+           std::log(theta - 1.0 + s);
+  };
+  return tools_eigen::binaryExpr_or_nan(u, f);
+}
+
 // inverse h-function
 inline Eigen::VectorXd JoeBicop::hinv1_raw(const Eigen::MatrixXd &u)
 {
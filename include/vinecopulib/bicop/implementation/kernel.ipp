@@ -25,6 +25,15 @@ inline KernelBicop::KernelBicop()
   npars_ = 0.0;
 }
 
+inline std::shared_ptr<AbstractBicop>
+KernelBicop::clone() const
+{
+  auto new_bicop =
+    std::static_pointer_cast<KernelBicop>(AbstractBicop::clone());
+  new_bicop->npars_ = npars_;
+  return new_bicop;
+}
+
 inline Eigen::VectorXd
 KernelBicop::pdf_raw(const Eigen::MatrixXd& u)
 {
@@ -98,19 +107,17 @@ KernelBicop::hinv2_raw(const Eigen::MatrixXd& u)
 inline double
 KernelBicop::parameters_to_tau(const Eigen::MatrixXd& parameters)
 {
-  auto oldpars = this->get_parameters();
-  auto old_types = var_types_;
-  this->set_parameters(parameters);
-  var_types_ = { "c", "c" };
+  // the parameters are set on a new (continuous) object, so that the tau of
+  // a model can be computed concurrently with other evaluations
+  auto cop =
+    std::static_pointer_cast<KernelBicop>(create(family_, parameters));
 
   std::vector<int> seeds = {
     204967043, 733593603, 184618802, 399707801, 290266245
   };
   auto u = tools_stats::ghalton(1000, 2, seeds);
-  u.col(1) = hinv1_raw(u);
+  u.col(1) = cop->hinv1_raw(u);
 
-  this->set_parameters(oldpars);
-  var_types_ = old_types;
   return wdm::wdm(u, "tau")(0, 1);
 }
 
@@ -56,12 +56,14 @@ ParBicop::get_npars()
   return static_cast<double>(parameters_.size());
 }
 
-// fit
+// fit; `tau` is Kendall's tau of the data (computed if NaN)
 inline void
 ParBicop::fit(const Eigen::MatrixXd& data,
               std::string method,
               double,
-              const Eigen::VectorXd& weights)
+              const Eigen::VectorXd& weights,
+              bool,
+              double tau)
 {
   // for independence copula we don't have to do anything
   if (family_ == BicopFamily::indep) {
@@ -70,7 +72,9 @@ ParBicop::fit(const Eigen::MatrixXd& data,
   }
 
   check_fit_method(method);
-  double tau = wdm::wdm(data, "tau", weights)(0, 1);
+  if (std::isnan(tau)) {
+    tau = wdm::wdm(data.leftCols(2), "tau", weights)(0, 1);
+  }
 
   // for method itau and one-parameter families we don't need to optimize
   int npars = static_cast<int>(get_npars()) - (method == "itau");
@@ -86,38 +90,67 @@ ParBicop::fit(const Eigen::MatrixXd& data,
   adjust_parameters_bounds(lb, ub, tau, method);
   auto initial_parameters = get_start_parameters(winsorize_tau(tau));
 
+  // the optimizers stay within the search box, so it is validated once and
+  // the objectives set the parameters without checks
+  if (method == "mle") {
+    check_parameters(lb);
+    check_parameters(ub);
+  }
+
   // find (pseudo-) mle
   std::function<double(const Eigen::VectorXd&)> objective;
+  std::function<double(
+    const Eigen::VectorXd&, Eigen::VectorXd&, Eigen::MatrixXd&)>
+    objective_and_derivatives;
   if (method == "mle") {
     objective = [&data, &weights, this](const Eigen::VectorXd& pars) {
-      this->set_parameters(pars);
+      this->parameters_ = pars;
       return this->loglik(data, weights);
     };
+    // analytic scores are available for all one-parameter families
+    if (tools_stl::is_member(family_, bicop_families::one_par) &&
+        (var_types_ == VarTypePair::cc)) {
+      objective_and_derivatives = [&data, &weights, this](
+                                    const Eigen::VectorXd& pars,
+                                    Eigen::VectorXd& gradient,
+                                    Eigen::MatrixXd& information) {
+        this->parameters_ = pars;
+        return this->loglik_and_score(data, weights, gradient, information);
+      };
+    }
   } else {
     // profile likelihood
     set_parameters(initial_parameters);
     initial_parameters(0) = initial_parameters(1);
     initial_parameters.conservativeResize(1);
+    auto box = parameters_;
+    box(1) = lb(0);
+    check_parameters(box);
+    box(1) = ub(0);
+    check_parameters(box);
     objective = [&data, &weights, this](const Eigen::VectorXd& pars) {
-      Eigen::VectorXd newpars(2);
-      newpars(0) = this->get_parameters()(0);
-      newpars(1) = pars(0);
-      this->set_parameters(newpars);
+      this->parameters_(1) = pars(0);
       return this->loglik(data, weights);
     };
   }
 
   tools_optimization::Optimizer optimizer;
-  auto newpars = optimizer.optimize(initial_parameters, lb, ub, objective);
+  auto optimize = [&](const Eigen::VectorXd& lower,
+                      const Eigen::VectorXd& upper) {
+    if (objective_and_derivatives) {
+      return optimizer.optimize(
+        initial_parameters, lower, upper, objective_and_derivatives);
+    }
+    return optimizer.optimize(initial_parameters, lower, upper, objective);
+  };
+  auto newpars = optimize(lb, ub);
 
   // check if fit is reasonable, otherwise increase search interval
   // and refit
   if (tools_stl::is_member(family_, bicop_families::one_par) &&
       (optimizer.get_objective_max() < -0.1)) {
-    newpars = optimizer.optimize(initial_parameters,
-                                 get_parameters_lower_bounds(),
-                                 get_parameters_upper_bounds(),
-                                 objective);
+    newpars =
+      optimize(get_parameters_lower_bounds(), get_parameters_upper_bounds());
   }
 
   // finalize fitted model
@@ -129,7 +162,52 @@ ParBicop::fit(const Eigen::MatrixXd& data,
   }
 
   set_parameters(newpars);
-  set_loglik(optimizer.get_objective_max());
+  if (objective_and_derivatives) {
+    // the analytic log-density is not trimmed like `pdf()`
+    set_loglik(loglik(data, weights));
+  } else {
+    set_loglik(optimizer.get_objective_max());
+  }
+}
+
+//! computes the log-density and its derivatives with respect to the
+//! parameters; the default throws an error since only some families
+//! implement it.
+//! @param u An \f$ n \times 2 \f$ matrix of evaluation points.
+//! @return An \f$ n \times (1 + p) \f$ matrix with the log-density in the
+//!   first and its derivatives in the remaining columns.
+inline Eigen::MatrixXd
+ParBicop::score_raw(const Eigen::MatrixXd&)
+{
+  throw std::runtime_error("score not implemented for " + get_family_name() +
+                           " copula.");
+}
+
+//! computes the log-likelihood, its gradient, and the outer product of
+//! the scores (an approximation of the negative Hessian) in a single pass.
+//! @param u An \f$ n \times 2 \f$ matrix of observations.
+//! @param weights Optional weights for each observation.
+//! @param gradient Set to the gradient of the log-likelihood.
+//! @param information Set to the (weighted) sum of the outer products of
+//!   the scores.
+inline double
+ParBicop::loglik_and_score(const Eigen::MatrixXd& u,
+                           const Eigen::VectorXd& weights,
+                           Eigen::VectorXd& gradient,
+                           Eigen::MatrixXd& information)
+{
+  Eigen::MatrixXd score = score_raw(u.leftCols(2));
+  Eigen::VectorXd w = weights;
+  tools_eigen::remove_nans(score, w);
+  auto s = score.rightCols(score.cols() - 1);
+  if (w.size() > 0) {
+    gradient = s.transpose() * w;
+    information = s.transpose() * w.asDiagonal() * s;
+    return score.col(0).dot(w);
+  }
+  gradient = s.colwise().sum().transpose();
+  information = s.transpose() * s;
+  return score.col(0).sum();
 }
 
 //! ensures that starting values are sufficiently separated from bounds
@@ -222,8 +300,8 @@ inline void
 ParBicop::check_parameters_lower(const Eigen::MatrixXd& parameters)
 {
   if (parameters_lower_bounds_.size() > 0) {
-    std::stringstream message;
     if ((parameters.array() < parameters_lower_bounds_.array()).any()) {
+      std::stringstream message;
       message << "parameters exceed lower bound "
               << "for " << get_family_name() << " copula; " << std::endl
               << "bound:" << std::endl
@@ -239,8 +317,8 @@ inline void
 ParBicop::check_parameters_upper(const Eigen::MatrixXd& parameters)
 {
   if (parameters_upper_bounds_.size() > 0) {
-    std::stringstream message;
     if ((parameters.array() > parameters_upper_bounds_.array()).any()) {
+      std::stringstream message;
       message << "parameters exceed upper bound "
               << "for " << get_family_name() << " copula; " << std::endl
               << "bound:" << std::endl
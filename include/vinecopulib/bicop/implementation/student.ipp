@@ -21,20 +21,16 @@ inline StudentBicop::StudentBicop()
 inline Eigen::VectorXd
 StudentBicop::pdf_raw(const Eigen::MatrixXd& u)
 {
-  double rho = double(this->parameters_(0));
-  double nu = double(this->parameters_(1));
-  Eigen::VectorXd f = Eigen::VectorXd::Ones(u.rows());
-  Eigen::MatrixXd tmp = tools_stats::qt(u, nu);
-
-  f = tmp.col(0).cwiseAbs2() + tmp.col(1).cwiseAbs2() -
-      (2 * rho) * tmp.rowwise().prod();
-  f /= nu * (1.0 - pow(rho, 2.0));
-  f = f + Eigen::VectorXd::Ones(u.rows());
-  f = f.array().pow(-(nu + 2.0) / 2.0);
-  f = f.cwiseQuotient(tools_stats::dt(tmp, nu).rowwise().prod());
-  f *= boost::math::tgamma_ratio((nu + 2.0) / 2.0, nu / 2.0);
-  f /= (nu * constant::pi * sqrt(1.0 - pow(rho, 2.0)));
+  Eigen::VectorXd f;
+  evaluate_raw(u, &f, nullptr, nullptr, false);
+  return f;
+}
 
+inline Eigen::VectorXd
+StudentBicop::logpdf_raw(const Eigen::MatrixXd& u)
+{
+  Eigen::VectorXd f;
+  evaluate_raw(u, &f, nullptr, nullptr, true);
   return f;
 }
 
@@ -63,15 +59,8 @@ inline Eigen::VectorXd StudentBicop::cdf(const Eigen::MatrixXd &u)
 inline Eigen::VectorXd
 StudentBicop::hfunc1_raw(const Eigen::MatrixXd& u)
 {
-  double rho = double(this->parameters_(0));
-  double nu = double(this->parameters_(1));
-  Eigen::VectorXd h = Eigen::VectorXd::Ones(u.rows());
-  Eigen::MatrixXd tmp = tools_stats::qt(u, nu);
-  h = nu * h + tmp.col(0).cwiseAbs2();
-  h *= (1.0 - pow(rho, 2)) / (nu + 1.0);
-  h = h.cwiseSqrt().cwiseInverse().cwiseProduct(tmp.col(1) - rho * tmp.col(0));
-  h = tools_stats::pt(h, nu + 1.0);
-
+  Eigen::VectorXd h;
+  evaluate_raw(u, nullptr, &h, nullptr, false);
   return h;
 }
 
@@ -93,6 +82,61 @@ inline Eigen::VectorXd StudentBicop::hinv1_raw(const Eigen::MatrixXd &u)
   return hinv;
 }
 
+inline void
+StudentBicop::evaluate_raw(const Eigen::MatrixXd& u,
+                           Eigen::VectorXd* pdf,
+                           Eigen::VectorXd* hfunc1,
+                           Eigen::VectorXd* hfunc2,
+                           bool log_pdf)
+{
+  double rho = double(this->parameters_(0));
+  double nu = double(this->parameters_(1));
+  Eigen::MatrixXd tmp = tools_stats::qt(u, nu);
+  if (pdf && log_pdf) {
+    double r2 = 1.0 - rho * rho;
+    // normalizing constants of the bivariate and (twice) the univariate
+    // t densities
+    double log_c =
+      std::log(boost::math::tgamma_ratio((nu + 2.0) / 2.0, nu / 2.0));
+    log_c -= std::log(nu * constant::pi) + 0.5 * std::log(r2);
+    log_c -= 2.0 * (boost::math::lgamma((nu + 1.0) / 2.0) -
+                    boost::math::lgamma(nu / 2.0) -
+                    0.5 * std::log(nu * constant::pi));
+    Eigen::ArrayXXd x2 = tmp.array().square() / nu;
+    Eigen::ArrayXd q = (tmp.col(0).cwiseAbs2() + tmp.col(1).cwiseAbs2() -
+                        (2 * rho) * tmp.rowwise().prod())
+                         .array() /
+                       (nu * r2);
+    *pdf = log_c - (nu + 2.0) / 2.0 * q.log1p() +
+           (nu + 1.0) / 2.0 * x2.log1p().rowwise().sum();
+  } else if (pdf) {
+    Eigen::VectorXd f = tmp.col(0).cwiseAbs2() + tmp.col(1).cwiseAbs2() -
+                        (2 * rho) * tmp.rowwise().prod();
+    f /= nu * (1.0 - pow(rho, 2.0));
+    f = f + Eigen::VectorXd::Ones(u.rows());
+    f = f.array().pow(-(nu + 2.0) / 2.0);
+    f = f.cwiseQuotient(tools_stats::dt(tmp, nu).rowwise().prod());
+    f *= boost::math::tgamma_ratio((nu + 2.0) / 2.0, nu / 2.0);
+    *pdf = f / (nu * constant::pi * sqrt(1.0 - pow(rho, 2.0)));
+  }
+
+  // h-function conditioning on the variable in column `cond`
+  auto hfunc = [&](size_t cond) {
+    Eigen::VectorXd h = Eigen::VectorXd::Ones(u.rows());
+    h = nu * h + tmp.col(cond).cwiseAbs2();
+    h *= (1.0 - pow(rho, 2)) / (nu + 1.0);
+    h = h.cwiseSqrt().cwiseInverse().cwiseProduct(tmp.col(1 - cond) -
+                                                  rho * tmp.col(cond));
+    return tools_stats::pt(h, nu + 1.0);
+  };
+  if (hfunc1) {
+    *hfunc1 = hfunc(0);
+  }
+  if (hfunc2) {
+    *hfunc2 = hfunc(1);
+  }
+}
+
 inline Eigen::VectorXd
 StudentBicop::get_start_parameters(const double tau)
 {
@@ -98,11 +98,10 @@ TllBicop::fit_local_likelihood(const Eigen::MatrixXd& x,
   Eigen::MatrixXd z_data = (irB * x_data.transpose()).transpose();
 
   Eigen::MatrixXd res(m, 2);
-  res.col(0) = Eigen::VectorXd::Ones(m); // result will be a product
   Eigen::VectorXd kernels(n);
   Eigen::Vector2d f1;
-  Eigen::Vector2d b;
-  Eigen::Matrix2d S(B);
+  Eigen::Vector2d b = Eigen::Vector2d::Zero();
+  Eigen::Matrix2d M2 = Eigen::Matrix2d::Zero();
   Eigen::MatrixXd zz(n, 2), zz2(n, 2);
   for (size_t k = 0; k < m; ++k) {
     zz = z_data - z.row(k).replicate(n, 1);
@@ -117,32 +116,243 @@ TllBicop::fit_local_likelihood(const Eigen::MatrixXd& x,
       if (method == "quadratic") {
         zz2 = zz.cwiseProduct(kernels.replicate(1, 2)) /
               (f0 * static_cast<double>(n));
-        b = B * b;
-        S = (B * (zz.transpose() * zz2) * B - b * b.transpose()).inverse();
-        res(k) *= std::sqrt(S.determinant()) / det_irB;
-      }
-      res(k) *= std::exp(-0.5 * double(b.transpose() * S * b));
-      if ((boost::math::isnan)(res(k)) | (boost::math::isinf)(res(k))) {
-        // inverse operation might go wrong due to rounding when
-        // true value is equal or close to zero
-        res(k) = 0.0;
+        M2 = zz.transpose() * zz2;
       }
     }
-    res(k, 0) *= f0;
+    double w = 1.0;
     if (weights.size() > 0) {
       // average weight in neighborhood of evaluation point (essentially a
       // kernel regression estimate);
       // kernels have already been multiplied with weights above
-      double w = kernels.sum() / kernels.cwiseQuotient(weights).sum();
-      res(k, 1) = calculate_infl(n, f0, b, B, det_irB, S, method, w);
-    } else {
-      res(k, 1) = calculate_infl(n, f0, b, B, det_irB, S, method, 1.0);
+      w = kernels.sum() / kernels.cwiseQuotient(weights).sum();
     }
+    res.row(k) =
+      local_likelihood_from_moments(n, f0, b, M2, B, det_irB, method, w);
   }
 
   return res;
 }
 
+//! evaluates local likelihood density estimate on binned data.
+//!
+//! The observations are linearly binned on a regular grid that refines the
+//! evaluation grid, such that each bin is small compared to the kernel. The
+//! kernel-weighted moments required by the estimator are then computed as
+//! discrete convolutions of the bin counts with tabulated kernels, which
+//! only need to be evaluated at the evaluation points.
+//!
+//! @param grid Equally spaced grid (on the normal scale); the evaluation
+//!   points are all pairs of grid points (in the order of
+//!   `tools_eigen::expand_grid()`).
+//! @param x_data Observations.
+//! @param B Bandwidth matrix.
+//! @param method Order of local polynomial approximation; either `"constant"`,
+//!   `"linear"`, or `"quadratic"`.
+//! @param weights Vector of weights for the observations
+//! @return a two-column matrix; first column is estimated density, second
+//!    column is influence of evaluation point.
+inline Eigen::MatrixXd
+TllBicop::fit_local_likelihood_binned(const Eigen::VectorXd& grid,
+                                      const Eigen::MatrixXd& x_data,
+                                      const Eigen::Matrix2d& B,
+                                      std::string method,
+                                      const Eigen::VectorXd& weights)
+{
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    RowMatrixXd;
+  ptrdiff_t m = grid.size(); // number of grid points per axis
+  size_t n = x_data.rows();  // number of observations
+
+  // pre-calculate inverse root of bandwidth matrix and determinant
+  Eigen::Matrix2d irB = chol22(B).inverse();
+  double det_irB = irB.determinant();
+
+  // bins are at most an eighth of the kernel's smallest standard deviation
+  // wide, and the evaluation points are nodes of the bin grid
+  double sd_min = std::sqrt(0.5 * (B(0, 0) + B(1, 1)) -
+                            std::sqrt(0.25 * std::pow(B(0, 0) - B(1, 1), 2) +
+                                      B(0, 1) * B(0, 1)));
+  double h = grid(1) - grid(0);
+  ptrdiff_t refine = static_cast<ptrdiff_t>(std::ceil(h / (0.125 * sd_min)));
+  refine = std::min(std::max(refine, ptrdiff_t(1)), ptrdiff_t(32));
+  double delta = h / static_cast<double>(refine);
+
+  // linear binning of the data
+  ptrdiff_t lo[2], n_bins[2];
+  for (size_t j = 0; j < 2; ++j) {
+    double x_min = (x_data.col(j).minCoeff() - grid(0)) / delta;
+    double x_max = (x_data.col(j).maxCoeff() - grid(0)) / delta;
+    lo[j] = std::min(ptrdiff_t(0), static_cast<ptrdiff_t>(std::floor(x_min)));
+    ptrdiff_t hi = std::max((m - 1) * refine,
+                            static_cast<ptrdiff_t>(std::ceil(x_max)));
+    n_bins[j] = hi - lo[j] + 1;
+  }
+  RowMatrixXd counts = RowMatrixXd::Zero(n_bins[0], n_bins[1]);
+  RowMatrixXd counts_unw;
+  if (weights.size() > 0) {
+    counts_unw = RowMatrixXd::Zero(n_bins[0], n_bins[1]);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    ptrdiff_t k[2];
+    double t[2];
+    for (size_t j = 0; j < 2; ++j) {
+      double pos =
+        (x_data(i, j) - grid(0)) / delta - static_cast<double>(lo[j]);
+      k[j] = std::min(static_cast<ptrdiff_t>(pos), n_bins[j] - 2);
+      t[j] = pos - static_cast<double>(k[j]);
+    }
+    double w = (weights.size() > 0) ? weights(i) : 1.0;
+    counts(k[0], k[1]) += w * (1 - t[0]) * (1 - t[1]);
+    counts(k[0] + 1, k[1]) += w * t[0] * (1 - t[1]);
+    counts(k[0], k[1] + 1) += w * (1 - t[0]) * t[1];
+    counts(k[0] + 1, k[1] + 1) += w * t[0] * t[1];
+    if (weights.size() > 0) {
+      counts_unw(k[0], k[1]) += (1 - t[0]) * (1 - t[1]);
+      counts_unw(k[0] + 1, k[1]) += t[0] * (1 - t[1]);
+      counts_unw(k[0], k[1] + 1) += (1 - t[0]) * t[1];
+      counts_unw(k[0] + 1, k[1] + 1) += t[0] * t[1];
+    }
+  }
+
+  // tabulate the kernel (times moments) for all offsets between bins that
+  // are within 7 standard deviations (the remaining kernel mass is
+  // negligible); the tables have one row per offset in the first variable
+  const double radius = 7.0;
+  ptrdiff_t r0 =
+    static_cast<ptrdiff_t>(std::ceil(radius * std::sqrt(B(0, 0)) / delta));
+  ptrdiff_t r1 =
+    static_cast<ptrdiff_t>(std::ceil(radius * std::sqrt(B(1, 1)) / delta));
+  size_t n_tabs = (method == "constant") ? 1 : ((method == "linear") ? 3 : 6);
+  std::vector<RowMatrixXd> tabs(n_tabs,
+                                RowMatrixXd::Zero(2 * r0 + 1, 2 * r1 + 1));
+  // columns with non-zero entries in each row of the tables
+  std::vector<ptrdiff_t> first(2 * r0 + 1, 2 * r1 + 1), last(2 * r0 + 1, -1);
+  for (ptrdiff_t o0 = -r0; o0 <= r0; ++o0) {
+    for (ptrdiff_t o1 = -r1; o1 <= r1; ++o1) {
+      Eigen::Vector2d zz =
+        irB * Eigen::Vector2d(static_cast<double>(o0) * delta,
+                              static_cast<double>(o1) * delta);
+      if (zz.squaredNorm() > radius * radius) {
+        continue;
+      }
+      double kernel = gaussian_kernel_2d(zz.transpose())(0) * det_irB;
+      first[o0 + r0] = std::min(first[o0 + r0], o1 + r1);
+      last[o0 + r0] = o1 + r1;
+      tabs[0](o0 + r0, o1 + r1) = kernel;
+      if (n_tabs > 1) {
+        zz = irB * zz;
+        tabs[1](o0 + r0, o1 + r1) = kernel * zz(0);
+        tabs[2](o0 + r0, o1 + r1) = kernel * zz(1);
+      }
+      if (n_tabs > 3) {
+        tabs[3](o0 + r0, o1 + r1) = kernel * zz(0) * zz(0);
+        tabs[4](o0 + r0, o1 + r1) = kernel * zz(0) * zz(1);
+        tabs[5](o0 + r0, o1 + r1) = kernel * zz(1) * zz(1);
+      }
+    }
+  }
+
+  // convolve counts and tables at the evaluation points
+  Eigen::MatrixXd res(m * m, 2);
+  Eigen::VectorXd sums(n_tabs);
+  Eigen::Vector2d b = Eigen::Vector2d::Zero();
+  Eigen::Matrix2d M2 = Eigen::Matrix2d::Zero();
+  for (ptrdiff_t i = 0; i < m; ++i) {
+    for (ptrdiff_t j = 0; j < m; ++j) {
+      // bin of the evaluation point
+      ptrdiff_t c0 = i * refine - lo[0];
+      ptrdiff_t c1 = j * refine - lo[1];
+      sums.setZero();
+      double sum_unw = 0.0;
+      ptrdiff_t o0_end = std::min(r0, n_bins[0] - 1 - c0);
+      for (ptrdiff_t o0 = std::max(-r0, -c0); o0 <= o0_end; ++o0) {
+        // restrict to non-zero kernels and bins within the grid
+        ptrdiff_t start = std::max(first[o0 + r0], r1 - c1);
+        ptrdiff_t end = std::min(last[o0 + r0], n_bins[1] - 1 - c1 + r1);
+        if (start > end) {
+          continue;
+        }
+        ptrdiff_t len = end - start + 1;
+        auto cnt = counts.row(c0 + o0).segment(c1 - r1 + start, len);
+        for (size_t l = 0; l < n_tabs; ++l) {
+          sums(l) += cnt.dot(tabs[l].row(o0 + r0).segment(start, len));
+        }
+        if (weights.size() > 0) {
+          sum_unw += counts_unw.row(c0 + o0)
+                       .segment(c1 - r1 + start, len)
+                       .dot(tabs[0].row(o0 + r0).segment(start, len));
+        }
+      }
+
+      ptrdiff_t k = i * m + j;
+      double f0 = sums(0) / static_cast<double>(n);
+      if (!(f0 > 0.0)) {
+        // no observations in the neighborhood of the evaluation point
+        res.row(k).setZero();
+        continue;
+      }
+      if (n_tabs > 1) {
+        b = sums.segment(1, 2) / sums(0);
+      }
+      if (n_tabs > 3) {
+        M2 << sums(3), sums(4), sums(4), sums(5);
+        M2 /= sums(0);
+      }
+      double w = (weights.size() > 0) ? sums(0) / sum_unw : 1.0;
+      res.row(k) =
+        local_likelihood_from_moments(n, f0, b, M2, B, det_irB, method, w);
+    }
+  }
+
+  return res;
+}
+
+//! computes the local likelihood density estimate and the influence of an
+//! evaluation point from kernel-weighted moments of the de-correlated data.
+//!
+//! @param n Number of observations.
+//! @param f0 Average kernel weight.
+//! @param b First moment, normalized by the sum of kernel weights.
+//! @param M2 Second moment, normalized by the sum of kernel weights (only
+//!   used for `method = "quadratic"`).
+//! @param B Bandwidth matrix.
+//! @param det_irB Determinant of the inverse root of `B`.
+//! @param method Order of local polynomial approximation.
+//! @param weight Average weight in the neighborhood of the evaluation point.
+//! @return a vector containing the estimated density and the influence.
+inline Eigen::Vector2d
+TllBicop::local_likelihood_from_moments(const size_t& n,
+                                        const double& f0,
+                                        const Eigen::Vector2d& b,
+                                        const Eigen::Matrix2d& M2,
+                                        const Eigen::Matrix2d& B,
+                                        const double& det_irB,
+                                        const std::string& method,
+                                        const double& weight)
+{
+  Eigen::Vector2d res;
+  Eigen::Vector2d bb = b;
+  Eigen::Matrix2d S(B);
+  res(0) = 1.0; // result will be a product
+  if (method != "constant") {
+    if (method == "quadratic") {
+      bb = B * b;
+      S = (B * M2 * B - bb * bb.transpose()).inverse();
+      res(0) *= std::sqrt(S.determinant()) / det_irB;
+    }
+    res(0) *= std::exp(-0.5 * double(bb.transpose() * S * bb));
+    if ((boost::math::isnan)(res(0)) | (boost::math::isinf)(res(0))) {
+      // inverse operation might go wrong due to rounding when
+      // true value is equal or close to zero
+      res(0) = 0.0;
+    }
+  }
+  res(0) *= f0;
+  res(1) = calculate_infl(n, f0, bb, B, det_irB, S, method, weight);
+
+  return res;
+}
+
 //! calculate influence for data point for density estimate based on
 //! quantities pre-computed in `fit_local_likelihood()`.
 inline double
@@ -215,7 +425,9 @@ inline void
 TllBicop::fit(const Eigen::MatrixXd& data,
               std::string method,
               double mult,
-              const Eigen::VectorXd& weights)
+              const Eigen::VectorXd& weights,
+              bool binned,
+              double)
 {
   using namespace tools_interpolation;
 
@@ -239,7 +451,13 @@ TllBicop::fit(const Eigen::MatrixXd& data,
   B *= mult;
 
   // compute the density estimator (first column estimate, second influence)
-  Eigen::MatrixXd ll_fit = fit_local_likelihood(z, z_data, B, method, weights);
+  Eigen::MatrixXd ll_fit;
+  if (binned) {
+    Eigen::VectorXd grid_z = tools_stats::qnorm(grid_points);
+    ll_fit = fit_local_likelihood_binned(grid_z, z_data, B, method, weights);
+  } else {
+    ll_fit = fit_local_likelihood(z, z_data, B, method, weights);
+  }
 
   // transform density estimate to copula scale
   Eigen::VectorXd c =
@@ -260,7 +478,7 @@ TllBicop::fit(const Eigen::MatrixXd& data,
   infl = Eigen::Map<Eigen::MatrixXd>(infl_vec.data(), m, m).transpose();
   // don't normalize margins of the EDF! (norm_times = 0)
   auto infl_grid = InterpolationGrid(grid_points, infl, 0);
-  if ((var_types_[0] == "d") | (var_types_[1] == "d")) {
+  if (var_types_ != VarTypePair::cc) {
     // for discrete, use mid ranks to compute EDF and log-likelihood
     // (this is closer to "observations" than jittered or "upper" pseudo data)
     psobs = 0.5 * (data.leftCols(2) + data.rightCols(2)).array();
@@ -4,8 +4,14 @@
 // the MIT license. For a copy, see the LICENSE file in the root directory of
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vinecopulib/misc/tools_batch.hpp>
+#include <vinecopulib/misc/tools_interface.hpp>
 #include <vinecopulib/misc/tools_stats.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
+#include <vinecopulib/misc/tools_thread.hpp>
 #include <wdm/eigen.hpp>
 
 namespace vinecopulib {
@@ -14,14 +20,16 @@ namespace tools_select {
 //! association direction.
 //! @param data Captured by reference to avoid data copies;
 //!     should NOT be modified though.
+//! @param controls The controls.
+//! @param tau Kendall's tau of the data.
 inline std::vector<Bicop>
 create_candidate_bicops(const Eigen::MatrixXd& data,
-                        const FitControlsBicop& controls)
+                        const FitControlsBicop& controls,
+                        double tau)
 {
   std::vector<BicopFamily> families = get_candidate_families(controls);
 
   // check whether dependence is negative or positive
-  double tau = wdm::wdm(data.leftCols(2), "tau", controls.get_weights())(0, 1);
   std::vector<int> which_rotations;
   if (tau > 0) {
     which_rotations = { 0, 180 };
@@ -194,5 +202,187 @@ preselect_family(std::vector<double> c, double tau, const Bicop& bicop)
   }
   return preselect;
 }
+
+//! @brief Returns a rough estimate of the cost of fitting a family.
+//!
+//! The cost is measured per observation and in units of evaluating the
+//! density of a one-parameter family. It is only meant for scheduling
+//! parallel work: two-parameter families are more expensive than
+//! one-parameter families, and fitting a nonparametric family is more
+//! expensive than any parametric fit.
+//!
+//! @param family The family.
+//! @param controls The fit controls.
+inline double
+get_fit_cost(BicopFamily family, const FitControlsBicop& controls)
+{
+  bool mle = (controls.get_parametric_method() == "mle");
+  if (family == BicopFamily::indep) {
+    return 1.0;
+  } else if (family == BicopFamily::tll) {
+    if (controls.get_nonparametric_binned()) {
+      return 50.0;
+    }
+    // the estimator is evaluated on a 30 x 30 grid
+    std::string method = controls.get_nonparametric_method();
+    if (method == "constant") {
+      return 500.0;
+    }
+    return (method == "linear") ? 750.0 : 1000.0;
+  } else if (family == BicopFamily::student) {
+    // the degrees of freedom are always found by maximum likelihood
+    return mle ? 150.0 : 50.0;
+  } else if (tools_stl::is_member(family, bicop_families::two_par)) {
+    return 50.0;
+  } else {
+    return mle ? 20.0 : 5.0;
+  }
+}
+
+//! @brief Computes the penalty of the selection criterion of a fitted model.
+//!
+//! The criterion is \f$ -2 \ell \f$ plus the penalty, where \f$ \ell \f$ is
+//! the log-likelihood. The penalty is zero for `"loglik"`, \f$ 2p \f$ for
+//! `"aic"`, and \f$ \log(n_{\mathrm{eff}}) p \f$ for `"bic"`, where \f$ p \f$
+//! is the number of parameters and \f$ n_{\mathrm{eff}} \f$ the effective
+//! sample size; `"mbic"` adds \f$ -2 \log \f$ of the prior probability.
+//!
+//! @param bicop The fitted model.
+//! @param nobs The number of observations.
+//! @param controls The fit controls (selection criterion, weights, and
+//!   prior probability).
+inline double
+get_criterion_penalty(const Bicop& bicop,
+                      size_t nobs,
+                      const FitControlsBicop& controls)
+{
+  std::string criterion = controls.get_selection_criterion();
+  double npars = bicop.get_npars();
+  if (criterion == "loglik") {
+    return 0.0;
+  } else if (criterion == "aic") {
+    return 2 * npars;
+  }
+
+  double n_eff = static_cast<double>(nobs);
+  Eigen::VectorXd weights = controls.get_weights();
+  if (weights.size() > 0) {
+    n_eff = std::pow(weights.sum(), 2) / weights.array().pow(2).sum();
+  }
+  double penalty = std::log(n_eff) * npars; // BIC
+  if (criterion == "mbic") {
+    // correction for mBIC
+    bool is_indep = (bicop.get_family() == BicopFamily::indep);
+    double psi0 = controls.get_psi0();
+    double log_prior = static_cast<double>(!is_indep) * std::log(psi0) +
+                       static_cast<double>(is_indep) * std::log(1.0 - psi0);
+    penalty -= 2 * log_prior;
+  }
+  return penalty;
+}
+
+//! @brief Discards candidate models by racing them on growing subsamples.
+//!
+//! The candidates are fit on a random subsample of 500 observations and
+//! their criteria are extrapolated to the full sample (the log-likelihood
+//! is scaled by the ratio of total weights, the penalty is computed for the
+//! full sample). A candidate is discarded if its criterion exceeds the best
+//! one by more than three standard errors of the difference; as in Vuong's
+//! test, the standard error is estimated from the pointwise log-likelihood
+//! differences on the subsample. The survivors are raced again on
+//! subsamples four times as large until a subsample would exceed half of
+//! the data.
+//!
+//! @param bicops The candidates; discarded candidates are removed, the
+//!   others remain unchanged and in the same order.
+//! @param data The data (without missing values).
+//! @param controls The fit controls.
+inline void
+race_candidates(std::vector<Bicop>& bicops,
+                const Eigen::MatrixXd& data,
+                const FitControlsBicop& controls)
+{
+  const double margin = 3.0;
+  size_t n = static_cast<size_t>(data.rows());
+  size_t size = 500;
+  if (2 * size > n) {
+    return;
+  }
+
+  // nested subsamples: leading elements of a random permutation (with a
+  // fixed seed, so that the selected model is reproducible)
+  std::vector<size_t> perm(n);
+  for (size_t i = 0; i < n; ++i) {
+    perm[i] = i;
+  }
+  std::mt19937 generator(5489u);
+  std::shuffle(perm.begin(), perm.end(), generator);
+
+  Eigen::VectorXd weights = controls.get_weights();
+  double total_weight =
+    (weights.size() > 0) ? weights.sum() : static_cast<double>(n);
+  size_t num_threads = controls.get_num_threads();
+  for (; (bicops.size() > 1) && (2 * size <= n); size *= 4) {
+    FitControlsBicop sub_controls = controls;
+    Eigen::MatrixXd sub_data(size, data.cols());
+    Eigen::VectorXd w = Eigen::VectorXd::Ones(size);
+    for (size_t i = 0; i < size; ++i) {
+      sub_data.row(i) = data.row(perm[i]);
+      if (weights.size() > 0) {
+        w(i) = weights(perm[i]);
+      }
+    }
+    if (weights.size() > 0) {
+      sub_controls.set_weights(w);
+    }
+
+    // fit on the subsample, store pointwise log-likelihoods and
+    // extrapolated criteria
+    size_t m = bicops.size();
+    double scale = total_weight / w.sum();
+    Eigen::MatrixXd ll(size, m);
+    Eigen::VectorXd crits(m);
+    auto fit_batch = [&](const std::vector<size_t>& batch) {
+      for (auto k : batch) {
+        tools_interface::check_user_interrupt();
+        Bicop cop = bicops[k];
+        cop.fit(sub_data, sub_controls);
+        ll.col(k) = cop.pdf(sub_data)
+                      .cwiseMax(std::numeric_limits<double>::min())
+                      .array()
+                      .log();
+        crits(k) = -2 * scale * w.dot(ll.col(k)) +
+                   get_criterion_penalty(cop, n, controls);
+      }
+    };
+    std::vector<double> costs;
+    for (auto& bc : bicops) {
+      costs.push_back(get_fit_cost(bc.get_family(), controls));
+    }
+    tools_thread::ThreadPool pool(num_threads);
+    pool.map(fit_batch, tools_batch::create_batches(costs, num_threads));
+    pool.wait();
+
+    // ties are broken by the order of candidates
+    size_t best = 0;
+    for (size_t k = 1; k < m; ++k) {
+      if (crits(k) < crits(best)) {
+        best = k;
+      }
+    }
+    double n_sub = std::pow(w.sum(), 2) / w.squaredNorm();
+    std::vector<Bicop> survivors;
+    for (size_t k = 0; k < m; ++k) {
+      Eigen::ArrayXd diff = ll.col(best) - ll.col(k);
+      double mean = w.dot(diff.matrix()) / w.sum();
+      double var = w.dot((diff - mean).square().matrix()) / w.sum();
+      double se = 2 * total_weight * std::sqrt(var / n_sub);
+      if (!(crits(k) - crits(best) > margin * se)) {
+        survivors.push_back(bicops[k]);
+      }
+    }
+    bicops = std::move(survivors);
+  }
+}
 }
 }
@@ -27,6 +27,9 @@ private:
   // PDF
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u);
 
+  // log-density
+  Eigen::VectorXd logpdf_raw(const Eigen::MatrixXd& u) override;
+
   // PDF
   Eigen::VectorXd cdf(const Eigen::MatrixXd& u);
 
@@ -32,6 +32,8 @@ public:
   KernelBicop();
 
 protected:
+  std::shared_ptr<AbstractBicop> clone() const override;
+
   Eigen::VectorXd pdf_raw(const Eigen::MatrixXd& u) override;
 
   Eigen::VectorXd pdf(const Eigen::MatrixXd& u) override;
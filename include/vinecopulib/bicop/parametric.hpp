@@ -37,13 +37,23 @@ protected:
   void fit(const Eigen::MatrixXd& data,
            std::string method,
            double,
-           const Eigen::VectorXd& weights);
+           const Eigen::VectorXd& weights,
+           bool,
+           double tau);
 
   double get_npars();
 
   virtual Eigen::VectorXd get_start_parameters(const double tau) = 0;
 
+  // log-density and its derivatives with respect to the parameters
+  virtual Eigen::MatrixXd score_raw(const Eigen::MatrixXd& u);
+
 private:
+  double loglik_and_score(const Eigen::MatrixXd& u,
+                          const Eigen::VectorXd& weights,
+                          Eigen::VectorXd& gradient,
+                          Eigen::MatrixXd& information);
+
   double winsorize_tau(double tau) const;
 
   void adjust_parameters_bounds(Eigen::MatrixXd& lb,
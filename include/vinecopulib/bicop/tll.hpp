@@ -36,6 +36,21 @@ private:
                                        std::string method,
                                        const Eigen::VectorXd& weights);
 
+  Eigen::MatrixXd fit_local_likelihood_binned(const Eigen::VectorXd& grid,
+                                              const Eigen::MatrixXd& x_data,
+                                              const Eigen::Matrix2d& B,
+                                              std::string method,
+                                              const Eigen::VectorXd& weights);
+
+  Eigen::Vector2d local_likelihood_from_moments(const size_t& n,
+                                                const double& f0,
+                                                const Eigen::Vector2d& b,
+                                                const Eigen::Matrix2d& M2,
+                                                const Eigen::Matrix2d& B,
+                                                const double& det_irB,
+                                                const std::string& method,
+                                                const double& weight);
+
   double calculate_infl(const size_t& n,
                         const double& f0,
                         const Eigen::Vector2d& b,
@@ -48,7 +63,9 @@ private:
   void fit(const Eigen::MatrixXd& data,
            std::string method,
            double mult,
-           const Eigen::VectorXd& weights);
+           const Eigen::VectorXd& weights,
+           bool binned,
+           double);
 };
 }
 
@@ -15,7 +15,8 @@ namespace tools_select {
 
 std::vector<Bicop>
 create_candidate_bicops(const Eigen::MatrixXd& data,
-                        const FitControlsBicop& controls);
+                        const FitControlsBicop& controls,
+                        double tau);
 
 std::vector<BicopFamily>
 get_candidate_families(const FitControlsBicop& controls);
@@ -33,6 +34,19 @@ get_c1c2(const Eigen::MatrixXd& data,
 
 bool
 preselect_family(std::vector<double> c, double tau, const Bicop& bicop);
+
+double
+get_fit_cost(BicopFamily family, const FitControlsBicop& controls);
+
+double
+get_criterion_penalty(const Bicop& bicop,
+                      size_t nobs,
+                      const FitControlsBicop& controls);
+
+void
+race_candidates(std::vector<Bicop>& bicops,
+                const Eigen::MatrixXd& data,
+                const FitControlsBicop& controls);
 }
 }
 
@@ -0,0 +1,206 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <vector>
+
+namespace vinecopulib {
+
+//! @brief An index for counting dominated points.
+//!
+//! For a fixed sample \f$ x_1, \dots, x_N \in \mathbb{R}^d \f$, the index
+//! counts the points \f$ x_i \f$ with \f$ x_i \le q \f$ (component-wise) for
+//! a query point \f$ q \f$. The points are organized in a kd-tree whose nodes
+//! store the bounding boxes of their points; subtrees whose boxes lie
+//! entirely below the query point are counted without visiting their points,
+//! and subtrees whose boxes are not below the query point in some dimension
+//! are skipped.
+class DominanceIndex
+{
+public:
+  DominanceIndex() = default;
+  explicit DominanceIndex(const Eigen::MatrixXd& x, size_t leaf_size = 32);
+
+  size_t count(const Eigen::Ref<const Eigen::RowVectorXd>& q) const;
+
+  size_t get_size() const;
+  size_t get_dim() const;
+
+private:
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    RowMatrixXd;
+
+  struct Node
+  {
+    size_t begin; //!< first point in the node
+    size_t end;   //!< one past the last point in the node
+    size_t left;  //!< index of the left child (0 for leaves)
+    size_t right; //!< index of the right child (0 for leaves)
+  };
+
+  size_t count_node(size_t k,
+                    const Eigen::Ref<const Eigen::RowVectorXd>& q,
+                    size_t* dims,
+                    size_t num_dims) const;
+  size_t build(const Eigen::MatrixXd& x,
+               std::vector<size_t>& perm,
+               size_t begin,
+               size_t end,
+               size_t leaf_size,
+               size_t depth);
+
+  RowMatrixXd points_;
+  std::vector<double> lower_; //!< lower corners of the nodes' bounding boxes
+  std::vector<double> upper_; //!< upper corners of the nodes' bounding boxes
+  std::vector<Node> nodes_;
+  size_t depth_{ 0 }; //!< depth of the tree
+};
+
+//! @brief Builds the index.
+//! @param x An \f$ N \times d \f$ matrix of points.
+//! @param leaf_size The maximal number of points in a leaf of the tree.
+inline DominanceIndex::DominanceIndex(const Eigen::MatrixXd& x,
+                                      size_t leaf_size)
+{
+  size_t n = static_cast<size_t>(x.rows());
+  leaf_size = std::max(leaf_size, static_cast<size_t>(1));
+  std::vector<size_t> perm(n);
+  for (size_t i = 0; i < n; ++i) {
+    perm[i] = i;
+  }
+  if (n > 0) {
+    build(x, perm, 0, n, leaf_size, 0);
+  }
+
+  // store points in the order of the leaves
+  points_.resize(n, x.cols());
+  for (size_t i = 0; i < n; ++i) {
+    points_.row(i) = x.row(perm[i]);
+  }
+}
+
+//! @brief Counts the points that are dominated by a query point.
+//! @param q A row vector of size \f$ d \f$.
+//! @return the number of points \f$ x_i \f$ with \f$ x_i \le q \f$.
+inline size_t
+DominanceIndex::count(const Eigen::Ref<const Eigen::RowVectorXd>& q) const
+{
+  if (nodes_.empty()) {
+    return 0;
+  }
+  // active dimensions of all nodes on the current path
+  size_t d = get_dim();
+  std::vector<size_t> dims(d * (depth_ + 2));
+  for (size_t j = 0; j < d; ++j) {
+    dims[j] = j;
+  }
+  return count_node(0, q, dims.data(), d);
+}
+
+//! @brief Returns the number of points in the index.
+inline size_t
+DominanceIndex::get_size() const
+{
+  return static_cast<size_t>(points_.rows());
+}
+
+//! @brief Returns the dimension of the points.
+inline size_t
+DominanceIndex::get_dim() const
+{
+  return static_cast<size_t>(points_.cols());
+}
+
+//! @brief Counts the dominated points in a subtree.
+//! @param k The index of the subtree's root.
+//! @param q The query point.
+//! @param dims The dimensions in which the parent's box is not entirely
+//!   below the query point (all points are below in the other dimensions),
+//!   followed by storage for the active dimensions of the descendants.
+//! @param num_dims The number of dimensions in `dims`.
+inline size_t
+DominanceIndex::count_node(size_t k,
+                           const Eigen::Ref<const Eigen::RowVectorXd>& q,
+                           size_t* dims,
+                           size_t num_dims) const
+{
+  const Node& node = nodes_[k];
+  const double* lower = &lower_[k * get_dim()];
+  const double* upper = &upper_[k * get_dim()];
+  size_t* active = dims + num_dims;
+  size_t num_active = 0;
+  for (size_t l = 0; l < num_dims; ++l) {
+    size_t j = dims[l];
+    if (lower[j] > q(j)) {
+      return 0;
+    }
+    active[num_active] = j;
+    num_active += (upper[j] > q(j));
+  }
+  if (num_active == 0) {
+    return node.end - node.begin;
+  }
+
+  if (node.left > 0) {
+    return count_node(node.left, q, active, num_active) +
+           count_node(node.right, q, active, num_active);
+  }
+  size_t count = 0;
+  for (size_t i = node.begin; i < node.end; ++i) {
+    const double* point = points_.data() + i * get_dim();
+    bool dominated = true;
+    for (size_t l = 0; l < num_active; ++l) {
+      dominated &= (point[active[l]] <= q(active[l]));
+    }
+    count += dominated;
+  }
+  return count;
+}
+
+//! @brief Builds the subtree for the points `perm[begin], ..., perm[end - 1]`
+//! by splitting at the median of the dimension with largest spread.
+//! @return the index of the subtree's root.
+inline size_t
+DominanceIndex::build(const Eigen::MatrixXd& x,
+                      std::vector<size_t>& perm,
+                      size_t begin,
+                      size_t end,
+                      size_t leaf_size,
+                      size_t depth)
+{
+  depth_ = std::max(depth_, depth);
+  size_t k = nodes_.size();
+  nodes_.push_back({ begin, end, 0, 0 });
+  Eigen::RowVectorXd lower = x.row(perm[begin]);
+  Eigen::RowVectorXd upper = lower;
+  for (size_t i = begin + 1; i < end; ++i) {
+    lower = lower.cwiseMin(x.row(perm[i]));
+    upper = upper.cwiseMax(x.row(perm[i]));
+  }
+  lower_.insert(lower_.end(), lower.data(), lower.data() + lower.size());
+  upper_.insert(upper_.end(), upper.data(), upper.data() + upper.size());
+  if (end - begin <= leaf_size) {
+    return k;
+  }
+
+  ptrdiff_t j;
+  (upper - lower).maxCoeff(&j);
+  size_t mid = begin + (end - begin) / 2;
+  std::nth_element(perm.begin() + begin,
+                   perm.begin() + mid,
+                   perm.begin() + end,
+                   [&x, j](size_t a, size_t b) { return x(a, j) < x(b, j); });
+  size_t left = build(x, perm, begin, mid, leaf_size, depth + 1);
+  size_t right = build(x, perm, mid, end, leaf_size, depth + 1);
+  nodes_[k].left = left;
+  nodes_[k].right = right;
+
+  return k;
+}
+}
@@ -5,8 +5,8 @@
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
 #include <boost/math/special_functions/fpclassify.hpp>
-#include <fstream>
 #include <iostream>
+#include <vinecopulib/misc/tools_io.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
 
 namespace vinecopulib {
@@ -80,7 +80,7 @@ trim(Eigen::MatrixXd& x, const double& lower, const double& upper)
 //! @param lower Lower bound of the interval.
 //! @param upper Upper bound of the interval.
 inline void
-trim(Eigen::VectorXd& x, const double& lower, const double& upper)
+trim(Eigen::Ref<Eigen::VectorXd> x, const double& lower, const double& upper)
 {
   // code of std::for_each (save some compile time by not including <algorithm>)
   auto it = x.data();
@@ -95,7 +95,7 @@ trim(Eigen::VectorXd& x, const double& lower, const double& upper)
 //! @param u Copula data.
 //! @return `true` if all data lie in the unit cube; throws an error otherwise.
 inline bool
-check_if_in_unit_cube(const Eigen::MatrixXd& u)
+check_if_in_unit_cube(const Eigen::Ref<const Eigen::MatrixXd>& u)
 {
   bool any_outside = (u.array() < 0.0).any() | (u.array() > 1.0).any();
   if (any_outside) {
@@ -202,54 +202,17 @@ read_matxs(const char* filename, int max_buffer_size)
 
 //! reads data from a file to an Eigen matrix of doubles.
 //!
-//! The function is currently **not safe** and may cause crashes when the
-//! arguments are specified incorrectly.
+//! Every non-empty line of the file corresponds to a row of the matrix;
+//! entries may be separated by spaces, tabs, commas, or semicolons (see
+//! `tools_io::read_csv()`).
 //!
 //! @param filename The name of the file to read from.
-//! @param max_buffer_size The maximal buffer size.
+//! @param max_buffer_size Unused; kept for backwards compatibility.
 inline Eigen::MatrixXd
 read_matxd(const char* filename, int max_buffer_size)
 {
-  using namespace std;
-
-  int cols = 0, rows = 0;
-  double* buff = new double[max_buffer_size];
-
-  // Read numbers from file into buffer.
-  ifstream infile;
-  infile.open(filename);
-  while (!infile.eof()) {
-    string line;
-    getline(infile, line);
-
-    int temp_cols = 0;
-    stringstream stream(line);
-    while (!stream.eof()) {
-      stream >> buff[cols * rows + temp_cols++];
-    }
-    if (temp_cols == 0) {
-      continue;
-    }
-    if (cols == 0) {
-      cols = temp_cols;
-    }
-    rows++;
-  }
-
-  infile.close();
-
-  rows--;
-
-  // Populate matrix with numbers.
-  Eigen::MatrixXd result(rows, cols);
-  for (int i = 0; i < rows; i++) {
-    for (int j = 0; j < cols; j++) {
-      result(i, j) = buff[cols * i + j];
-    }
-  }
-
-  delete[] buff;
-  return result;
+  (void)max_buffer_size;
+  return tools_io::read_csv(filename);
 }
 
 //! @}
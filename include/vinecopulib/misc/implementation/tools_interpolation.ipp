@@ -4,6 +4,7 @@
 // the MIT license. For a copy, see the LICENSE file in the root directory of
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
+#include <algorithm>
 #include <stdexcept>
 #include <vinecopulib/misc/tools_eigen.hpp>
 
@@ -31,6 +32,7 @@ inline InterpolationGrid::InterpolationGrid(const Eigen::VectorXd& grid_points,
 
   grid_points_ = grid_points;
   values_ = values;
+  init_lookup();
   normalize_margins(norm_times);
 }
 
@@ -68,6 +70,7 @@ inline void
 InterpolationGrid::flip()
 {
   values_.transposeInPlace();
+  compute_tables();
 }
 
 //! renormalizes the estimate to uniform margins
@@ -87,30 +90,152 @@ InterpolationGrid::normalize_margins(int times)
         std::max(int_on_grid(1.0, values_.col(j), grid_points_), 1e-20);
     }
   }
+  compute_tables();
 }
 
-inline Eigen::Matrix<ptrdiff_t, 1, 2>
-InterpolationGrid::get_indices(double x0, double x1)
+//! tabulates the cumulative integrals used by `integrate_1d()` and
+//! `integrate_2d()`
+inline void
+InterpolationGrid::compute_tables()
 {
-  Eigen::Matrix<ptrdiff_t, 1, 2> out;
-  out.setZero();
-  bool found_i = false;
-  bool found_j = false;
-  for (ptrdiff_t k = 1; k < (grid_points_.size() - 1); ++k) {
-    if ((x0 >= grid_points_(k))) {
-      out(0) = k;
-    } else {
-      found_i = true;
+  values_h_ = values_.array().max(1e-4);
+  cum_cols_ = cumulate(values_);
+  cum_rows_ = cumulate(values_.transpose()).transpose();
+  cum_h_cols_ = cumulate(values_h_);
+  cum_h_rows_ = cumulate(values_h_.transpose()).transpose();
+  cum_2d_ = cumulate(cum_rows_);
+}
+
+//! integrates the columns of a matrix from 0 to every grid point
+//!
+//! @param vals A matrix of values with one row per grid point.
+//! @return a matrix whose (i, j)th entry equals
+//!   `int_on_grid(grid_points_(i), vals.col(j), grid_points_)`.
+inline Eigen::MatrixXd
+InterpolationGrid::cumulate(const Eigen::MatrixXd& vals) const
+{
+  Eigen::MatrixXd cum(vals.rows(), vals.cols());
+  cum.row(0).setZero();
+  for (ptrdiff_t k = 1; k < vals.rows(); ++k) {
+    cum.row(k) = cum.row(k - 1) + (vals.row(k) + vals.row(k - 1)) *
+                                    (grid_points_(k) - grid_points_(k - 1)) /
+                                    2.0;
+  }
+  return cum;
+}
+
+//! locates the upper limit of an integral on the grid
+//!
+//! With these weights, `int_on_grid(upr, vals, grid_points_)` equals
+//! `cum(k) + a * vals(k) + b * vals(k + 1)`, where `cum` contains the
+//! cumulative integrals computed by `cumulate()`.
+//!
+//! @param upr Upper limit of integration (lower is 0).
+//! @param k Index of the grid cell containing `upr`.
+//! @param a Weight for the lower end of the cell.
+//! @param b Weight for the upper end of the cell.
+inline void
+InterpolationGrid::get_int_weights(double upr,
+                                   ptrdiff_t& k,
+                                   double& a,
+                                   double& b) const
+{
+  ptrdiff_t m = grid_points_.size();
+  a = 0.0;
+  b = 0.0;
+  if (upr <= grid_points_(0)) {
+    k = 0;
+  } else if (upr >= grid_points_(m - 1)) {
+    // integrate over the full last cell
+    k = m - 2;
+    a = (grid_points_(m - 1) - grid_points_(m - 2)) / 2.0;
+    b = a;
+  } else {
+    k = get_index(upr);
+    double d = upr - grid_points_(k);
+    double t = d / (grid_points_(k + 1) - grid_points_(k));
+    a = d * (1.0 - t / 2.0);
+    b = d * t / 2.0;
+  }
+}
+
+//! chooses how points are located on the grid
+//!
+//! The interval spanned by the grid is split into equally sized buckets such
+//! that no bucket contains more than two grid cells (the Gaussian-quantile
+//! grids used for kernel estimators need about 30 buckets per cell). A table
+//! maps each bucket to its first cell, so that points are located by an
+//! arithmetic index and at most a few comparisons. If the table would be too
+//! large (very unevenly spaced grids), binary search is used instead.
+inline void
+InterpolationGrid::init_lookup()
+{
+  ptrdiff_t m = grid_points_.size();
+  lookup_method_ = LookupMethod::binary_search;
+  lookup_table_.clear();
+  if (m < 3) {
+    return;
+  }
+
+  double range = grid_points_(m - 1) - grid_points_(0);
+  double min_width = (grid_points_.tail(m - 1) - grid_points_.head(m - 1))
+                       .minCoeff();
+  if (!(min_width > 0.0) ||
+      (range / min_width > 100.0 * static_cast<double>(m))) {
+    return;
+  }
+
+  size_t n_buckets = static_cast<size_t>(std::ceil(range / min_width));
+  lookup_scale_ = static_cast<double>(n_buckets) / range;
+  lookup_table_.resize(n_buckets);
+  ptrdiff_t k = 0;
+  for (size_t b = 0; b < n_buckets; ++b) {
+    double lower = grid_points_(0) + static_cast<double>(b) / lookup_scale_;
+    while ((k < m - 2) && (lower >= grid_points_(k + 1))) {
+      ++k;
     }
-    if ((x1 >= grid_points_(k))) {
-      out(1) = k;
-    } else {
-      found_j = true;
+    lookup_table_[b] = k;
+  }
+  lookup_method_ = LookupMethod::table;
+}
+
+//! locates a point on the grid
+//!
+//! @param x The point.
+//! @return the index `k` of the cell [grid_points_(k), grid_points_(k + 1)]
+//!   containing `x`; 0 (m - 2) for points below (above) the grid.
+inline ptrdiff_t
+InterpolationGrid::get_index(double x) const
+{
+  ptrdiff_t m = grid_points_.size();
+  ptrdiff_t k;
+  if (lookup_method_ == LookupMethod::table) {
+    double pos = (x - grid_points_(0)) * lookup_scale_;
+    if (!(pos > 0.0)) {
+      return 0;
     }
-    if (found_i & found_j) {
-      break;
+    size_t b = std::min(static_cast<size_t>(pos), lookup_table_.size() - 1);
+    k = lookup_table_[b];
+    // the bucket may start at a grid point or end in the next cell
+    if ((k > 0) && (x < grid_points_(k))) {
+      --k;
     }
+    while ((k < m - 2) && (x >= grid_points_(k + 1))) {
+      ++k;
+    }
+  } else {
+    const double* begin = grid_points_.data() + 1;
+    const double* end = grid_points_.data() + std::max(m - 1, ptrdiff_t(1));
+    k = std::upper_bound(begin, end, x) - begin;
   }
+  return k;
+}
+
+inline Eigen::Matrix<ptrdiff_t, 1, 2>
+InterpolationGrid::get_indices(double x0, double x1)
+{
+  Eigen::Matrix<ptrdiff_t, 1, 2> out;
+  out << get_index(x0), get_index(x1);
   return out;
 }
 
@@ -177,31 +302,34 @@ InterpolationGrid::interpolate(const Eigen::MatrixXd& x)
 
 //! Integrate the grid along one axis
 //!
+//! The values on the grid are bounded from below by 1e-4 for stability.
+//!
 //! @param u Mx2 matrix of evaluation points
 //! @param cond_var Either 1 or 2; the axis considered fixed.
 //! @return a vector of resulting integral values
 inline Eigen::VectorXd
 InterpolationGrid::integrate_1d(const Eigen::MatrixXd& u, size_t cond_var)
 {
-  ptrdiff_t m = grid_points_.size();
-  Eigen::VectorXd tmpvals(m);
-  Eigen::MatrixXd tmpgrid(m, 2);
-
-  auto f = [this, m, cond_var, &tmpvals, &tmpgrid](double u1, double u2) {
-    double upr = 0.0;
-    double tmpint = 0.0, int1;
-    if (cond_var == 1) {
-      upr = u2;
-      tmpgrid.col(0) = Eigen::VectorXd::Constant(m, u1);
-      tmpgrid.col(1) = grid_points_;
-    } else if (cond_var == 2) {
-      upr = u1;
-      tmpgrid.col(0) = grid_points_;
-      tmpgrid.col(1) = Eigen::VectorXd::Constant(m, u2);
-    }
-    tmpvals = interpolate(tmpgrid).array().max(1e-4);
-    tmpint = int_on_grid(upr, tmpvals, grid_points_);
-    int1 = int_on_grid(1.0, tmpvals, grid_points_);
+  auto f = [this, cond_var](double u1, double u2) {
+    // the integrand interpolates linearly between two neighboring rows (or
+    // columns) of the grid, so its integral interpolates between theirs
+    double x = (cond_var == 1) ? u1 : u2;
+    double upr = (cond_var == 1) ? u2 : u1;
+    ptrdiff_t i = this->get_index(x);
+    double w = (x - grid_points_(i)) / (grid_points_(i + 1) - grid_points_(i));
+    auto int_on_line = [this, cond_var](ptrdiff_t line, double limit) {
+      ptrdiff_t k;
+      double a, b;
+      this->get_int_weights(limit, k, a, b);
+      if (cond_var == 1) {
+        return cum_h_rows_(line, k) + a * values_h_(line, k) +
+               b * values_h_(line, k + 1);
+      }
+      return cum_h_cols_(k, line) + a * values_h_(k, line) +
+             b * values_h_(k + 1, line);
+    };
+    double tmpint = (1 - w) * int_on_line(i, upr) + w * int_on_line(i + 1, upr);
+    double int1 = (1 - w) * int_on_line(i, 1.0) + w * int_on_line(i + 1, 1.0);
 
     return std::min(std::max(tmpint / int1, 1e-10), 1 - 1e-10);
   };
@@ -216,24 +344,26 @@ InterpolationGrid::integrate_1d(const Eigen::MatrixXd& u, size_t cond_var)
 inline Eigen::VectorXd
 InterpolationGrid::integrate_2d(const Eigen::MatrixXd& u)
 {
-  ptrdiff_t m = grid_points_.size();
-  Eigen::VectorXd tmpvals(m), tmpvals2(m);
-  Eigen::MatrixXd tmpgrid(m, 2);
-  tmpgrid.col(1) = grid_points_;
-
-  auto f = [this, m, &tmpvals, &tmpvals2, &tmpgrid](double u1, double u2) {
-    double upr, tmpint, tmpint1;
-    upr = u2;
-    for (ptrdiff_t k = 0; k < m; ++k) {
-      tmpgrid.col(0) = Eigen::VectorXd::Constant(m, grid_points_(k));
-      tmpvals = interpolate(tmpgrid);
-      tmpint = int_on_grid(upr, tmpvals, grid_points_);
-      tmpvals2(k) = tmpint;
-    }
-    upr = u1;
-    tmpint = int_on_grid(upr, tmpvals2, grid_points_);
-    tmpint1 = int_on_grid(1.0, tmpvals2, grid_points_);
-    return std::min(std::max(tmpint / tmpint1, 1e-10), 1 - 1e-10);
+  auto f = [this](double u1, double u2) {
+    // integrate the rows up to u2, then the result up to u1; the partial
+    // integrals are linear combinations of the rows and columns of the grid
+    ptrdiff_t i, j;
+    double a1, b1, a2, b2;
+    this->get_int_weights(u2, j, a2, b2);
+    auto int_to = [&](ptrdiff_t row, double lo_w, double hi_w) {
+      return cum_2d_(row, j) + lo_w * cum_rows_(row, j) +
+             hi_w * cum_rows_(row + 1, j) +
+             a2 * (cum_cols_(row, j) + lo_w * values_(row, j) +
+                   hi_w * values_(row + 1, j)) +
+             b2 * (cum_cols_(row, j + 1) + lo_w * values_(row, j + 1) +
+                   hi_w * values_(row + 1, j + 1));
+    };
+    this->get_int_weights(u1, i, a1, b1);
+    double tmpint = int_to(i, a1, b1);
+    this->get_int_weights(1.0, i, a1, b1);
+    double tmpint1 = int_to(i, a1, b1);
+    // rescale such that the second margin is exactly uniform
+    return std::min(std::max(tmpint / tmpint1 * u2, 1e-10), 1 - 1e-10);
   };
 
   return tools_eigen::binaryExpr_or_nan(u, f);
@@ -0,0 +1,369 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vinecopulib/misc/tools_interface.hpp>
+#include <vinecopulib/misc/tools_stl.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VINECOPULIB_HAS_MMAP
+#endif
+
+namespace vinecopulib {
+
+namespace tools_io {
+
+//! @name Reading and writing data
+//! @{
+
+//! reads the numbers in a line of text.
+//! @param begin Pointer to the start of the line.
+//! @param end Pointer to the end of the line (i.e., the newline character or
+//!   the end of the buffer).
+//! @param values Vector the numbers are appended to.
+//! @return the number of values in the line.
+inline size_t
+parse_line(const char* begin, const char* end, std::vector<double>& values)
+{
+  size_t cols = 0;
+  while (true) {
+    while ((begin < end) && ((*begin == ' ') || (*begin == '\t') ||
+                             (*begin == ',') || (*begin == ';') ||
+                             (*begin == '\r'))) {
+      ++begin;
+    }
+    if (begin == end) {
+      break;
+    }
+    char* stop;
+    double value = std::strtod(begin, &stop);
+    if ((stop == begin) || (stop > end)) {
+      std::stringstream msg;
+      msg << "invalid entry '"
+          << std::string(begin, std::min(end, begin + 20)) << "'.";
+      throw std::runtime_error(msg.str());
+    }
+    values.push_back(value);
+    begin = stop;
+    ++cols;
+  }
+
+  return cols;
+}
+
+//! reads a data set from a text file.
+//!
+//! Every non-empty line of the file corresponds to one observation; entries
+//! may be separated by spaces, tabs, commas, or semicolons. The file is split
+//! into chunks at line breaks, which are parsed in parallel.
+//!
+//! @param filename The name of the file to read from.
+//! @param num_threads The number of threads to use for parsing.
+//! @return a matrix with one row per observation.
+inline Eigen::MatrixXd
+read_csv(const std::string& filename, size_t num_threads)
+{
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file) {
+    throw std::runtime_error("could not open file '" + filename + "'.");
+  }
+  std::string text(static_cast<size_t>(file.tellg()), '\0');
+  file.seekg(0);
+  file.read(&text[0], static_cast<std::streamsize>(text.size()));
+  file.close();
+
+  // chunk boundaries are placed after line breaks
+  size_t min_chunk_size = static_cast<size_t>(1) << 20;
+  size_t num_chunks = std::max(
+    static_cast<size_t>(1),
+    std::min(4 * std::max(num_threads, static_cast<size_t>(1)),
+             text.size() / min_chunk_size));
+  std::vector<size_t> bounds(1, 0);
+  for (size_t k = 1; k < num_chunks; ++k) {
+    size_t pos = text.find('\n', k * text.size() / num_chunks);
+    if ((pos == std::string::npos) || (pos + 1 <= bounds.back())) {
+      continue;
+    }
+    bounds.push_back(pos + 1);
+  }
+  bounds.push_back(text.size());
+  num_chunks = bounds.size() - 1;
+
+  struct Chunk
+  {
+    std::vector<double> values;
+    size_t rows{ 0 };
+    size_t cols{ 0 };
+    std::string error;
+  };
+  std::vector<Chunk> chunks(num_chunks);
+  auto parse_chunk = [&](size_t k) {
+    Chunk& chunk = chunks[k];
+    const char* pos = text.data() + bounds[k];
+    const char* end = text.data() + bounds[k + 1];
+    try {
+      while (pos < end) {
+        const char* line_end =
+          static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (!line_end) {
+          line_end = end;
+        }
+        size_t cols = parse_line(pos, line_end, chunk.values);
+        if (cols > 0) {
+          if ((chunk.cols > 0) && (cols != chunk.cols)) {
+            throw std::runtime_error("lines have different numbers of "
+                                     "entries.");
+          }
+          chunk.cols = cols;
+          chunk.rows++;
+        }
+        pos = line_end + 1;
+      }
+    } catch (const std::exception& e) {
+      chunk.error = e.what();
+    }
+  };
+  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
+  pool.map(parse_chunk, tools_stl::seq_int(0, num_chunks));
+  pool.join();
+
+  size_t rows = 0, cols = 0;
+  for (const auto& chunk : chunks) {
+    if (!chunk.error.empty()) {
+      throw std::runtime_error("reading '" + filename + "' failed: " +
+                               chunk.error);
+    }
+    if (chunk.rows == 0) {
+      continue;
+    }
+    if ((cols > 0) && (chunk.cols != cols)) {
+      throw std::runtime_error("reading '" + filename + "' failed: lines " +
+                               "have different numbers of entries.");
+    }
+    cols = chunk.cols;
+    rows += chunk.rows;
+  }
+
+  Eigen::MatrixXd data(rows, cols);
+  size_t row = 0;
+  for (const auto& chunk : chunks) {
+    if (chunk.rows > 0) {
+      data.middleRows(row, chunk.rows) =
+        Eigen::Map<const Eigen::Matrix<double,
+                                       Eigen::Dynamic,
+                                       Eigen::Dynamic,
+                                       Eigen::RowMajor>>(
+          chunk.values.data(), chunk.rows, cols);
+      row += chunk.rows;
+    }
+  }
+
+  return data;
+}
+
+//! writes a data set to a file in vinecopulib's binary format (see
+//! `MappedData`).
+//!
+//! @param filename The name of the file to write to.
+//! @param data The data set.
+//! @param var_types Strings specifying the types of the variables,
+//!   e.g., `("c", "d")` means first variable continuous, second discrete.
+//!   If empty, all variables are assumed to be continuous.
+inline void
+write_binary(const std::string& filename,
+             const Eigen::Ref<const Eigen::MatrixXd>& data,
+             const std::vector<std::string>& var_types)
+{
+  size_t cols = static_cast<size_t>(data.cols());
+  if (!var_types.empty() && (var_types.size() != cols)) {
+    throw std::runtime_error("var_types must have one entry per column.");
+  }
+  std::vector<char> types((cols + 7) / 8 * 8, '\0');
+  for (size_t j = 0; j < cols; ++j) {
+    std::string type = var_types.empty() ? "c" : var_types[j];
+    if ((type != "c") && (type != "d")) {
+      throw std::runtime_error("var type must be either 'c' or 'd'.");
+    }
+    types[j] = type[0];
+  }
+
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("could not open file '" + filename + "'.");
+  }
+  uint64_t header[4] = { 0x0102030405060708,
+                         1,
+                         static_cast<uint64_t>(data.rows()),
+                         static_cast<uint64_t>(cols) };
+  file.write("VCLDATA", 8);
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+  file.write(types.data(), static_cast<std::streamsize>(types.size()));
+  for (size_t j = 0; j < cols; ++j) {
+    Eigen::VectorXd col = data.col(j);
+    file.write(reinterpret_cast<const char*>(col.data()),
+               static_cast<std::streamsize>(col.size() * sizeof(double)));
+  }
+  if (!file) {
+    throw std::runtime_error("writing '" + filename + "' failed.");
+  }
+}
+
+//! maps a file in vinecopulib's binary format into memory.
+//! @param filename The name of the file.
+inline MappedData::MappedData(const std::string& filename)
+{
+  this->map_file(filename);
+  try {
+    this->read_header(filename);
+  } catch (...) {
+    this->unmap_file();
+    throw;
+  }
+}
+
+inline MappedData::~MappedData()
+{
+  this->unmap_file();
+}
+
+//! @return a (read-only) view on the data; valid as long as the object
+//!   exists.
+inline Eigen::Map<const Eigen::MatrixXd>
+MappedData::get_data() const
+{
+  auto data = reinterpret_cast<const double*>(bytes_ + offset_);
+  return Eigen::Map<const Eigen::MatrixXd>(data, rows_, cols_);
+}
+
+//! @return the types of the variables.
+inline std::vector<std::string>
+MappedData::get_var_types() const
+{
+  return var_types_;
+}
+
+//! @return the number of observations.
+inline size_t
+MappedData::get_rows() const
+{
+  return rows_;
+}
+
+//! @return the number of variables.
+inline size_t
+MappedData::get_cols() const
+{
+  return cols_;
+}
+
+inline void
+MappedData::map_file(const std::string& filename)
+{
+#ifdef VINECOPULIB_HAS_MMAP
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("could not open file '" + filename + "'.");
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw std::runtime_error("could not read file '" + filename + "'.");
+  }
+  num_bytes_ = static_cast<size_t>(info.st_size);
+  if (num_bytes_ > 0) {
+    void* addr = mmap(nullptr, num_bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr != MAP_FAILED) {
+      bytes_ = static_cast<const char*>(addr);
+      mapped_ = true;
+    }
+  }
+  close(fd);
+  if (mapped_) {
+    return;
+  }
+#endif
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file) {
+    throw std::runtime_error("could not open file '" + filename + "'.");
+  }
+  // store as doubles to make sure that the data are properly aligned
+  num_bytes_ = static_cast<size_t>(file.tellg());
+  buffer_.resize((num_bytes_ + sizeof(double) - 1) / sizeof(double));
+  file.seekg(0);
+  bytes_ = reinterpret_cast<const char*>(buffer_.data());
+  file.read(reinterpret_cast<char*>(buffer_.data()),
+            static_cast<std::streamsize>(num_bytes_));
+}
+
+inline void
+MappedData::unmap_file()
+{
+#ifdef VINECOPULIB_HAS_MMAP
+  if (mapped_) {
+    munmap(const_cast<char*>(bytes_), num_bytes_);
+    mapped_ = false;
+  }
+#endif
+  bytes_ = nullptr;
+  num_bytes_ = 0;
+}
+
+inline void
+MappedData::read_header(const std::string& filename)
+{
+  auto fail = [&filename](const std::string& reason) {
+    throw std::runtime_error("reading '" + filename + "' failed: " + reason);
+  };
+
+  uint64_t header[4];
+  if ((num_bytes_ < 8 + sizeof(header)) ||
+      (std::memcmp(bytes_, "VCLDATA", 8) != 0)) {
+    fail("not a vinecopulib data file.");
+  }
+  std::memcpy(header, bytes_ + 8, sizeof(header));
+  if (header[0] != 0x0102030405060708) {
+    fail("file was written on a machine with different byte order.");
+  }
+  if (header[1] != 1) {
+    fail("unsupported format version.");
+  }
+  rows_ = static_cast<size_t>(header[2]);
+  cols_ = static_cast<size_t>(header[3]);
+  // the header has a multiple of 8 bytes, so the data are properly aligned
+  offset_ = 8 + sizeof(header) + (cols_ + 7) / 8 * 8;
+  if ((cols_ > num_bytes_) || (offset_ > num_bytes_)) {
+    fail("file size does not match the dimensions.");
+  }
+  size_t num_values = (num_bytes_ - offset_) / sizeof(double);
+  if ((offset_ + num_values * sizeof(double) != num_bytes_) ||
+      ((cols_ == 0) && (num_values > 0)) ||
+      ((cols_ > 0) && ((rows_ > num_values / cols_) ||
+                       (rows_ * cols_ != num_values)))) {
+    fail("file size does not match the dimensions.");
+  }
+
+  var_types_.resize(cols_);
+  for (size_t j = 0; j < cols_; ++j) {
+    char type = bytes_[8 + sizeof(header) + j];
+    if ((type != 'c') && (type != 'd')) {
+      fail("invalid variable type.");
+    }
+    var_types_[j] = std::string(1, type);
+  }
+}
+
+//! @}
+}
+}
@@ -5,6 +5,7 @@
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
 #include <boost/math/tools/minima.hpp>
+#include <cmath>
 #include <vinecopulib/misc/tools_bobyqa.hpp>
 
 namespace vinecopulib {
@@ -92,6 +93,120 @@ Optimizer::optimize(const Eigen::VectorXd& initial_parameters,
   return optimal_parameters;
 }
 
+//! @brief Solve the maximization problem using first derivatives.
+//!
+//! The problem is solved by a projected quasi-Newton method with
+//! backtracking line search. Each call of the objective returns its value,
+//! gradient, and a positive semi-definite approximation of the negative
+//! Hessian (for likelihoods, the sum of outer products of the individual
+//! scores). The approximation at the starting values is refined by BFGS
+//! updates. Steps are projected onto the (slightly shrunk) bounds and halved
+//! until the Armijo condition holds; the iterations stop once the predicted
+//! increase of the objective is negligible. Starting close to the optimum,
+//! this usually needs a handful of calls.
+//!
+//! @param initial_parameters Starting values for the optimization
+//!     algorithm.
+//! @param lower_bounds Lower bounds for the parameters.
+//! @param upper_bounds Upper bounds for the parameters.
+//! @param objective_and_derivatives Function returning the objective to
+//!     maximize and writing its gradient and the approximate negative
+//!     Hessian into the second and third arguments.
+//! @return the optimal parameters.
+inline Eigen::VectorXd
+Optimizer::optimize(const Eigen::VectorXd& initial_parameters,
+                    const Eigen::VectorXd& lower_bounds,
+                    const Eigen::VectorXd& upper_bounds,
+                    std::function<double(const Eigen::VectorXd&,
+                                         Eigen::VectorXd&,
+                                         Eigen::MatrixXd&)>
+                      objective_and_derivatives)
+{
+  check_parameters_size(initial_parameters, lower_bounds, upper_bounds);
+  size_t n_parameters = initial_parameters.size();
+  double eps = 1e-6;
+  Eigen::VectorXd lb = lower_bounds.array() + eps;
+  Eigen::VectorXd ub = upper_bounds.array() - eps;
+  auto project = [&lb, &ub](const Eigen::VectorXd& x) -> Eigen::VectorXd {
+    return x.cwiseMax(lb).cwiseMin(ub);
+  };
+  size_t num_calls = 0;
+  auto f = [&](const Eigen::VectorXd& x,
+               Eigen::VectorXd& grad,
+               Eigen::MatrixXd& info) {
+    num_calls++;
+    objective_calls_++;
+    grad.resize(n_parameters);
+    info.resize(n_parameters, n_parameters);
+    return objective_and_derivatives(x, grad, info);
+  };
+
+  Eigen::VectorXd x = project(initial_parameters);
+  Eigen::VectorXd grad, new_grad;
+  Eigen::MatrixXd hess, info;
+  double value = f(x, grad, hess);
+
+  const double armijo = 1e-4;
+  const double ftol = 1e-8;
+  const size_t maxeval = static_cast<size_t>(controls_.get_maxeval());
+  while (std::isfinite(value) && (num_calls < maxeval)) {
+    // Newton direction (regularized in case of a singular approximation);
+    // directions pointing outside of active bounds are blocked
+    Eigen::MatrixXd reg = hess;
+    reg.diagonal().array() += 1e-10 * (1 + hess.diagonal().array().abs());
+    Eigen::VectorXd direction = reg.ldlt().solve(grad);
+    if (!direction.allFinite() || !(grad.dot(direction) > 0)) {
+      direction = grad / (1 + grad.norm());
+    }
+    for (size_t i = 0; i < n_parameters; ++i) {
+      if (((x(i) <= lb(i)) && (direction(i) < 0)) ||
+          ((x(i) >= ub(i)) && (direction(i) > 0))) {
+        direction(i) = 0;
+      }
+    }
+    if (grad.dot(project(x + direction) - x) <= ftol * (1 + std::fabs(value))) {
+      break;
+    }
+
+    // backtracking along the projected path
+    double step = 1.0;
+    double new_value = value;
+    Eigen::VectorXd new_x = x;
+    bool accepted = false;
+    for (size_t k = 0; (k < 30) && (num_calls < maxeval); ++k) {
+      new_x = project(x + step * direction);
+      new_value = f(new_x, new_grad, info);
+      if (new_value >= value + armijo * grad.dot(new_x - x)) {
+        accepted = true;
+        break;
+      }
+      step /= 2;
+    }
+    if (!accepted) {
+      break;
+    }
+
+    // BFGS update of the curvature; the approximation supplied by the
+    // objective is only used when the update is not well defined
+    Eigen::VectorXd s = new_x - x;
+    Eigen::VectorXd y = grad - new_grad;
+    Eigen::VectorXd hs = hess * s;
+    double sy = s.dot(y);
+    double shs = s.dot(hs);
+    if ((sy > 1e-10 * s.norm() * y.norm()) && (shs > 0)) {
+      hess += y * y.transpose() / sy - hs * hs.transpose() / shs;
+    } else {
+      hess = info;
+    }
+    x = new_x;
+    value = new_value;
+    grad = new_grad;
+  }
+  objective_max_ = value;
+
+  return x;
+}
+
 //! @brief Returns how often the objective function was called.
 inline size_t
 Optimizer::get_objective_calls() const
@@ -5,7 +5,7 @@
 // vinecopulib or https://vinecopulib.github.io/vinecopulib/.
 
 #include <random>
-#include <unsupported/Eigen/FFT>
+#include <vinecopulib/misc/tools_interface.hpp>
 #include <vinecopulib/misc/tools_stats_ghalton.hpp>
 #include <vinecopulib/misc/tools_stats_sobol.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
@@ -23,23 +23,31 @@ namespace tools_stats {
 //! @param qrng If true, quasi-numbers are generated.
 //! @param seeds Seeds of the random number generator; if empty (default),
 //!   the random number generator is seeded randomly.
+//! @param num_threads The number of threads to use for generating the
+//!   numbers; the result does not depend on it.
 //!
 //! If `qrng = TRUE`, generalized Halton sequences (see `ghalton()`) are used
 //! for \f$ d \leq 300 \f$ and Sobol sequences otherwise (see `sobol()`).
 //!
+//! Pseudo-random numbers are generated (in column-major order) in blocks of
+//! \f$ 2^{16} \f$ numbers, each from a Mersenne twister with its own seed
+//! sequence. The first block uses `seeds`, the following ones `seeds`
+//! extended by the block number.
+//!
 //! @return An \f$ n \times d \f$ matrix of independent
 //! \f$ \mathrm{U}[0, 1] \f$ random variables.
 inline Eigen::MatrixXd
 simulate_uniform(const size_t& n,
                  const size_t& d,
                  bool qrng,
-                 std::vector<int> seeds)
+                 std::vector<int> seeds,
+                 size_t num_threads)
 {
   if (qrng) {
     if (d > 300) {
-      return tools_stats::sobol(n, d, seeds);
+      return tools_stats::sobol(n, d, seeds, num_threads);
     } else {
-      return tools_stats::ghalton(n, d, seeds);
+      return tools_stats::ghalton(n, d, seeds, num_threads);
     }
   }
   if ((n < 1) || (d < 1)) {
@@ -53,13 +61,31 @@ simulate_uniform(const size_t& n,
       seeds.begin(), seeds.end(), [&]() { return static_cast<int>(rd()); });
   }
 
-  // initialize random engine and uniform distribution
-  std::seed_seq seq(seeds.begin(), seeds.end());
-  std::mt19937 generator(seq);
-  std::uniform_real_distribution<double> distribution(0.0, 1.0);
-
   Eigen::MatrixXd u(n, d);
-  return u.unaryExpr([&](double) { return distribution(generator); });
+  const size_t block_size = static_cast<size_t>(1) << 16;
+  auto fill_block = [&](size_t block) {
+    // initialize random engine and uniform distribution
+    auto block_seeds = seeds;
+    if (block > 0) {
+      block_seeds.push_back(0x5eed);
+      block_seeds.push_back(static_cast<int>(block));
+    }
+    std::seed_seq seq(block_seeds.begin(), block_seeds.end());
+    std::mt19937 generator(seq);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+    size_t end = std::min((block + 1) * block_size, n * d);
+    for (size_t k = block * block_size; k < end; k++) {
+      u.data()[k] = distribution(generator);
+    }
+  };
+
+  size_t num_blocks = (n * d + block_size - 1) / block_size;
+  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
+  pool.map(fill_block, tools_stl::seq_int(0, num_blocks));
+  pool.join();
+
+  return u;
 }
 
 //! @brief Applies the empirical probability integral transform to a data
@@ -139,22 +165,31 @@ to_pseudo_obs_1d(Eigen::VectorXd x, const std::string& ties_method)
 }
 
 //! window smoother
+//!
+//! Computes moving averages over windows of length `2 * wl + 1` from running
+//! sums; the first and last `wl` values are set to the closest average over a
+//! full window.
 inline Eigen::VectorXd
 win(const Eigen::VectorXd& x, size_t wl = 5)
 {
-  size_t n = x.size();
-  Eigen::VectorXd xx = Eigen::VectorXd::Zero(n + 2 * wl);
-  Eigen::VectorXd yy = Eigen::VectorXd::Zero(n + 2 * wl);
-  xx.block(2 * wl, 0, n, 1) = x;
-  yy.block(0, 0, 2 * wl + 1, 1) = Eigen::VectorXd::Ones(2 * wl + 1);
-
-  Eigen::FFT<double> fft;
-  Eigen::VectorXcd tmp1 = fft.fwd(xx);
-  Eigen::VectorXcd tmp2 = fft.fwd(yy);
-  tmp2 = tmp2.conjugate();
-  tmp1 = tmp1.cwiseProduct(tmp2);
-  tmp2 = fft.inv(tmp1);
-  Eigen::VectorXd result = tmp2.real().block(wl, 0, n, 1);
+  ptrdiff_t n = x.size();
+  ptrdiff_t w = static_cast<ptrdiff_t>(wl);
+  Eigen::VectorXd result(n);
+  // sums are accumulated in extended precision to avoid a build-up of
+  // rounding errors along the window
+  long double sum = 0.0;
+  for (ptrdiff_t i = 0; i < std::min(w, n); ++i) {
+    sum += x(i);
+  }
+  for (ptrdiff_t i = 0; i < n; ++i) {
+    if (i + w < n) {
+      sum += x(i + w);
+    }
+    if (i - w - 1 >= 0) {
+      sum -= x(i - w - 1);
+    }
+    result(i) = static_cast<double>(sum);
+  }
   result /= 2.0 * static_cast<double>(wl) + 1.0;
   result.block(0, 0, wl, 1) = Eigen::VectorXd::Constant(wl, result(wl));
   result.block(n - wl, 0, wl, 1) =
@@ -309,11 +344,16 @@ pairwise_mcor(const Eigen::MatrixXd& x, const Eigen::VectorXd& weights)
 //! @param d Dimension.
 //! @param seeds Seeds to scramble the quasi-random numbers; if empty (default),
 //!   the quasi-random number generator is seeded randomly.
+//! @param num_threads The number of threads to use for generating the
+//!   numbers; the result does not depend on it.
 //!
 //! @return An \f$ n \times d \f$ matrix of quasi-random
 //! \f$ \mathrm{U}[0, 1] \f$ variables.
 inline Eigen::MatrixXd
-ghalton(const size_t& n, const size_t& d, const std::vector<int>& seeds)
+ghalton(const size_t& n,
+        const size_t& d,
+        const std::vector<int>& seeds,
+        size_t num_threads)
 {
 
   Eigen::MatrixXd res(d, n);
@@ -321,41 +361,44 @@ ghalton(const size_t& n, const size_t& d, const std::vector<int>& seeds)
   // Coefficients of the shift
   Eigen::MatrixXi shcoeff(d, 32);
   Eigen::VectorXi base = tools_ghalton::primes.block(0, 0, d, 1);
-  Eigen::MatrixXd u = Eigen::VectorXd::Zero(d, 1);
   auto U = simulate_uniform(d, 32, false, seeds);
+  // tail.col(k) is the radical inverse computed from the digits k, ..., 31,
+  // which are all zero (and only shifted) for indices below base^k
+  Eigen::MatrixXd tail(d, 33);
+  tail.col(32).setZero();
   for (int k = 31; k >= 0; k--) {
     shcoeff.col(k) =
       (base.cast<double>()).cwiseProduct(U.block(0, k, d, 1)).cast<int>();
-    u = (u + shcoeff.col(k).cast<double>()).cwiseQuotient(base.cast<double>());
+    tail.col(k) = (tail.col(k + 1) + shcoeff.col(k).cast<double>())
+                    .cwiseQuotient(base.cast<double>());
   }
-  res.block(0, 0, d, 1) = u;
 
   Eigen::VectorXi perm = tools_ghalton::permTN2.block(0, 0, d, 1);
-  Eigen::MatrixXi coeff(d, 32);
-  Eigen::VectorXi tmp(d);
-  auto mod = [](const int& u1, const int& u2) { return u1 % u2; };
-  for (size_t i = 1; i < n; i++) {
+  auto do_batch = [&](const tools_batch::Batch& b) {
+    int digits[32];
+    for (size_t i = b.begin; i < b.begin + b.size; i++) {
+      for (size_t j = 0; j < d; j++) {
+        // Find i in the prime base
+        int num_digits = 0;
+        for (int m = static_cast<int>(i); (m > 0) && (num_digits < 32);
+             m /= base(j)) {
+          digits[num_digits++] = m % base(j);
+        }
 
-    // Find i in the prime base
-    tmp = Eigen::VectorXi::Constant(d, static_cast<int>(i));
-    coeff = Eigen::MatrixXi::Zero(d, 32);
-    int k = 0;
-    while ((tmp.maxCoeff() > 0) && (k < 32)) {
-      coeff.col(k) = tmp.binaryExpr(base, mod);
-      tmp = tmp.cwiseQuotient(base);
-      k++;
+        double u = tail(j, num_digits);
+        for (int k = num_digits - 1; k >= 0; k--) {
+          int tmp = perm(j) * digits[k] + shcoeff(j, k);
+          u = u + static_cast<double>(tmp % base(j));
+          u = u / static_cast<double>(base(j));
+        }
+        res(j, i) = u;
+      }
     }
+  };
 
-    u = Eigen::VectorXd::Zero(d);
-    k = 31;
-    while (k >= 0) {
-      tmp = perm.cwiseProduct(coeff.col(k)) + shcoeff.col(k);
-      u = u + tmp.binaryExpr(base, mod).cast<double>();
-      u = u.cwiseQuotient(base.cast<double>());
-      k--;
-    }
-    res.block(0, i, d, 1) = u;
-  }
+  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
+  pool.map(do_batch, tools_batch::create_batches(n, num_threads));
+  pool.join();
 
   return res.transpose();
 }
@@ -370,11 +413,17 @@ ghalton(const size_t& n, const size_t& d, const std::vector<int>& seeds)
 //! @param d Dimension.
 //! @param seeds Seeds to scramble the quasi-random numbers; if empty (default),
 //!   the quasi-random number generator is seeded randomly.
+//! @param num_threads The number of threads to use for generating the
+//!   numbers (the dimensions are generated concurrently); the result does
+//!   not depend on it.
 //!
 //! @return An \f$ n \times d \f$ matrix of quasi-random
 //! \f$ \mathrm{U}[0, 1] \f$ variables.
 inline Eigen::MatrixXd
-sobol(const size_t& n, const size_t& d, const std::vector<int>& seeds)
+sobol(const size_t& n,
+      const size_t& d,
+      const std::vector<int>& seeds,
+      size_t num_threads)
 {
 
   // output matrix
@@ -399,50 +448,44 @@ sobol(const size_t& n, const size_t& d, const std::vector<int>& seeds)
     }
   }
 
-  // Compute the first dimension
-
-  // Compute direction numbers scaled by pow(2,32)
-  Eigen::Matrix<size_t, Eigen::Dynamic, 1> V(L);
-  for (size_t i = 0; i < L; i++) {
-    V(i) = static_cast<size_t>(std::pow(2, 32 - (i + 1))); // all m's = 1
-  }
-
-  // Evalulate X scaled by pow(2,32)
-  Eigen::Matrix<size_t, Eigen::Dynamic, 1> X(n);
-  X(0) = static_cast<size_t>(scrambling(0) * std::pow(2.0, 32));
-  for (size_t i = 1; i < n; i++) {
-    X(i) = X(i - 1) ^ V(C(i - 1) - 1);
-  }
-  output.block(0, 0, n, 1) = X.cast<double>();
-
-  // Compute the remaining dimensions
-  for (size_t j = 0; j < d - 1; j++) {
+  auto compute_dim = [&](size_t j) {
+    // Compute direction numbers scaled by pow(2,32)
+    Eigen::Matrix<size_t, Eigen::Dynamic, 1> V(L);
+    if (j == 0) {
+      for (size_t i = 0; i < L; i++) {
+        V(i) = static_cast<size_t>(std::pow(2, 32 - (i + 1))); // all m's = 1
+      }
+    } else {
+      // Get parameters from static vectors
+      size_t a = tools_sobol::a_sobol[j - 1];
+      size_t s = tools_sobol::s_sobol[j - 1];
 
-    // Get parameters from static vectors
-    size_t a = tools_sobol::a_sobol[j];
-    size_t s = tools_sobol::s_sobol[j];
+      Eigen::Map<Eigen::Matrix<size_t, Eigen::Dynamic, 1>> m(
+        tools_sobol::minit_sobol[j - 1], s);
 
-    Eigen::Map<Eigen::Matrix<size_t, Eigen::Dynamic, 1>> m(
-      tools_sobol::minit_sobol[j], s);
+      for (size_t i = 0; i < std::min(L, s); i++)
+        V(i) = m(i) << (32 - (i + 1));
 
-    // Compute direction numbers scaled by pow(2,32)
-    for (size_t i = 0; i < std::min(L, s); i++)
-      V(i) = m(i) << (32 - (i + 1));
-
-    if (L > s) {
-      for (size_t i = s; i < L; i++) {
-        V(i) = V(i - s) ^ (V(i - s) >> s);
-        for (size_t k = 0; k < s - 1; k++)
-          V(i) ^= (((a >> (s - 2 - k)) & 1) * V(i - k - 1));
+      if (L > s) {
+        for (size_t i = s; i < L; i++) {
+          V(i) = V(i - s) ^ (V(i - s) >> s);
+          for (size_t k = 0; k < s - 1; k++)
+            V(i) ^= (((a >> (s - 2 - k)) & 1) * V(i - k - 1));
+        }
       }
     }
 
-    // Evalulate X
-    X(0) = static_cast<size_t>(scrambling(j + 1) * std::pow(2.0, 32));
+    // Evalulate X scaled by pow(2,32)
+    Eigen::Matrix<size_t, Eigen::Dynamic, 1> X(n);
+    X(0) = static_cast<size_t>(scrambling(j) * std::pow(2.0, 32));
     for (size_t i = 1; i < n; i++)
       X(i) = X(i - 1) ^ V(C(i - 1) - 1);
-    output.block(0, j + 1, n, 1) = X.cast<double>();
-  }
+    output.col(j) = X.cast<double>();
+  };
+
+  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
+  pool.map(compute_dim, tools_stl::seq_int(0, d));
+  pool.join();
 
   // Scale output by pow(2,32)
   output /= std::pow(2.0, 32);
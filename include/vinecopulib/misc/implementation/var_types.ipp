@@ -0,0 +1,120 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include <stdexcept>
+
+namespace vinecopulib {
+
+//! @brief Converts a VarType into its string representation.
+//! @param type The variable type.
+inline std::string
+get_var_type_name(VarType type)
+{
+  return (type == VarType::discrete) ? "d" : "c";
+}
+
+//! @brief Converts a string into a VarType.
+//! @param type Either `"c"` (continuous) or `"d"` (discrete).
+inline VarType
+get_var_type_enum(const std::string& type)
+{
+  if (type == "c") {
+    return VarType::continuous;
+  } else if (type == "d") {
+    return VarType::discrete;
+  }
+  throw std::runtime_error("var type must be either 'c' or 'd'.");
+}
+
+//! @brief Converts VarTypes into their string representations.
+//! @param types The variable types.
+inline std::vector<std::string>
+get_var_type_names(const std::vector<VarType>& types)
+{
+  std::vector<std::string> names(types.size());
+  for (size_t i = 0; i < types.size(); ++i) {
+    names[i] = get_var_type_name(types[i]);
+  }
+  return names;
+}
+
+//! @brief Converts strings into VarTypes.
+//! @param types Strings that are either `"c"` or `"d"`.
+inline std::vector<VarType>
+get_var_type_enums(const std::vector<std::string>& types)
+{
+  std::vector<VarType> enums(types.size());
+  for (size_t i = 0; i < types.size(); ++i) {
+    enums[i] = get_var_type_enum(types[i]);
+  }
+  return enums;
+}
+
+//! @brief Combines the types of two variables.
+//! @param type1 The type of the first variable.
+//! @param type2 The type of the second variable.
+inline VarTypePair
+get_var_type_pair(VarType type1, VarType type2)
+{
+  return static_cast<VarTypePair>(static_cast<unsigned char>(type1) |
+                                  (static_cast<unsigned char>(type2) << 1));
+}
+
+//! @brief Converts two strings into a VarTypePair.
+//! @param types A vector of two strings that are either `"c"` or `"d"`.
+inline VarTypePair
+get_var_type_pair(const std::vector<std::string>& types)
+{
+  if (types.size() != 2) {
+    throw std::runtime_error("var_types must have size two.");
+  }
+  return get_var_type_pair(get_var_type_enum(types[0]),
+                           get_var_type_enum(types[1]));
+}
+
+//! @brief Converts a VarTypePair into two strings.
+//! @param types The types of the two variables.
+inline std::vector<std::string>
+get_var_type_names(VarTypePair types)
+{
+  return { get_var_type_name(get_var_type(types, 0)),
+           get_var_type_name(get_var_type(types, 1)) };
+}
+
+//! @brief Extracts the type of one variable.
+//! @param types The types of the two variables.
+//! @param i The index of the variable (0 or 1).
+inline VarType
+get_var_type(VarTypePair types, size_t i)
+{
+  return static_cast<VarType>((static_cast<unsigned char>(types) >> i) & 1);
+}
+
+//! @brief Checks whether one of two variables is discrete.
+//! @param types The types of the two variables.
+//! @param i The index of the variable (0 or 1).
+inline bool
+is_discrete(VarTypePair types, size_t i)
+{
+  return get_var_type(types, i) == VarType::discrete;
+}
+
+//! @brief Counts the discrete variables in a pair.
+//! @param types The types of the two variables.
+inline unsigned short
+count_discrete(VarTypePair types)
+{
+  return is_discrete(types, 0) + is_discrete(types, 1);
+}
+
+//! @brief Swaps the types of the two variables.
+//! @param types The types of the two variables.
+inline VarTypePair
+flip_var_types(VarTypePair types)
+{
+  return get_var_type_pair(get_var_type(types, 1), get_var_type(types, 0));
+}
+}
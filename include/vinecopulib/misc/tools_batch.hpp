@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <vector>
 
 namespace vinecopulib {
@@ -30,6 +32,16 @@ compute_num_batches(size_t num_tasks, size_t num_threads)
   return std::min(num_tasks, num_batches);
 }
 
+//! @brief Splits tasks of (roughly) equal cost into batches.
+//!
+//! The batches are processed in order and get smaller towards the end
+//! (guided scheduling): each batch contains a fixed fraction of the remaining
+//! tasks, but at least `num_tasks / compute_num_batches()` tasks. Threads
+//! start with large batches and the small batches at the end keep all
+//! threads busy until the work is done.
+//!
+//! @param num_tasks Number of tasks.
+//! @param num_threads Number of threads processing the batches.
 inline std::vector<Batch>
 create_batches(size_t num_tasks, size_t num_threads)
 {
@@ -37,15 +49,56 @@ create_batches(size_t num_tasks, size_t num_threads)
     return { Batch{ 0, 0 } };
   num_threads = std::max(static_cast<size_t>(1), num_threads);
 
-  size_t num_batches = compute_num_batches(num_tasks, num_threads);
-  std::vector<Batch> batches(num_batches);
+  size_t min_size = num_tasks / compute_num_batches(num_tasks, num_threads);
+  std::vector<Batch> batches;
+  for (size_t i = 0; i < num_tasks;) {
+    size_t remaining = num_tasks - i;
+    size_t size = std::max(min_size, remaining / (2 * num_threads));
+    batches.push_back(Batch{ i, std::min(size, remaining) });
+    i += batches.back().size;
+  }
+
+  return batches;
+}
+
+//! @brief Groups tasks with heterogeneous costs into batches.
+//!
+//! Tasks are sorted by decreasing cost, so that expensive tasks are started
+//! first and cheap tasks fill the gaps at the end. Consecutive tasks are
+//! grouped until a batch accounts for a fixed fraction of the remaining cost,
+//! so that batches of cheap tasks get smaller towards the end.
+//!
+//! @param costs Estimated (relative) costs of the tasks.
+//! @param num_threads Number of threads processing the batches.
+//! @return The indices of the tasks in each batch, in the order in which
+//!   the batches should be processed.
+inline std::vector<std::vector<size_t>>
+create_batches(const std::vector<double>& costs, size_t num_threads)
+{
+  num_threads = std::max(static_cast<size_t>(1), num_threads);
+  std::vector<size_t> order(costs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t i, size_t j) {
+    return costs[i] > costs[j];
+  });
 
-  size_t min_size = num_tasks / num_batches;
-  ptrdiff_t rem_size = num_tasks % num_batches;
-  for (size_t i = 0, k = 0; i < num_tasks; k++) {
-    batches[k] = Batch{ i, min_size + (rem_size-- > 0) };
-    i += batches[k].size;
+  double remaining = std::accumulate(costs.begin(), costs.end(), 0.0);
+  double fraction = 1.0 / (2.0 * static_cast<double>(num_threads));
+  std::vector<std::vector<size_t>> batches;
+  std::vector<size_t> batch;
+  double batch_cost = 0.0;
+  for (auto i : order) {
+    batch.push_back(i);
+    batch_cost += costs[i];
+    if (batch_cost >= fraction * remaining) {
+      remaining -= batch_cost;
+      batches.push_back(batch);
+      batch.clear();
+      batch_cost = 0.0;
+    }
   }
+  if (batch.size() > 0)
+    batches.push_back(batch);
 
   return batches;
 }
@@ -57,12 +57,12 @@ trim(Eigen::MatrixXd& x,
      const double& upper = 1 - 1e-10);
 
 void
-trim(Eigen::VectorXd& x,
+trim(Eigen::Ref<Eigen::VectorXd> x,
      const double& lower = 1e-10,
      const double& upper = 1 - 1e-10);
 
 bool
-check_if_in_unit_cube(const Eigen::MatrixXd& u);
+check_if_in_unit_cube(const Eigen::Ref<const Eigen::MatrixXd>& u);
 
 Eigen::MatrixXd
 swap_cols(Eigen::MatrixXd u);
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <vector>
 
 namespace vinecopulib {
 
@@ -14,7 +15,9 @@ namespace tools_interpolation {
 //! A class for cubic spline interpolation of bivariate copulas
 //!
 //! The class is used for implementing kernel estimators. It makes storing the
-//! observations obsolete and allows for fast numerical integration.
+//! observations obsolete and allows for fast numerical integration: the
+//! cumulative integrals along both axes are tabulated whenever the values
+//! change, so that integrals are computed by a lookup and an interpolation.
 class InterpolationGrid
 {
 public:
@@ -39,7 +42,19 @@ public:
   Eigen::VectorXd integrate_2d(const Eigen::MatrixXd& u);
 
 private:
+  //! strategies for locating points on the grid
+  enum class LookupMethod
+  {
+    table,        //!< table of cells for equally sized buckets.
+    binary_search //!< binary search over the grid points.
+  };
+
+  void init_lookup();
+  ptrdiff_t get_index(double x) const;
   Eigen::Matrix<ptrdiff_t, 1, 2> get_indices(double x0, double x1);
+  void compute_tables();
+  Eigen::MatrixXd cumulate(const Eigen::MatrixXd& vals) const;
+  void get_int_weights(double upr, ptrdiff_t& k, double& a, double& b) const;
   double bilinear_interpolation(double z11,
                                 double z12,
                                 double z21,
@@ -56,6 +71,19 @@ private:
 
   Eigen::VectorXd grid_points_;
   Eigen::MatrixXd values_;
+
+  LookupMethod lookup_method_{ LookupMethod::binary_search };
+  std::vector<ptrdiff_t> lookup_table_;
+  double lookup_scale_{ 0.0 };
+
+  // tables for integration: cumulative integrals of the columns and rows of
+  // the values, and of the values bounded from below (used for h-functions)
+  Eigen::MatrixXd values_h_;
+  Eigen::MatrixXd cum_cols_;
+  Eigen::MatrixXd cum_rows_;
+  Eigen::MatrixXd cum_h_cols_;
+  Eigen::MatrixXd cum_h_rows_;
+  Eigen::MatrixXd cum_2d_;
 };
 }
 }
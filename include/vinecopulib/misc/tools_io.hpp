@@ -0,0 +1,74 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+namespace vinecopulib {
+
+//! Tools for reading and writing data sets
+namespace tools_io {
+
+Eigen::MatrixXd
+read_csv(const std::string& filename, size_t num_threads = 1);
+
+void
+write_binary(const std::string& filename,
+             const Eigen::Ref<const Eigen::MatrixXd>& data,
+             const std::vector<std::string>& var_types = {});
+
+//! @brief A data set in vinecopulib's binary format, mapped into memory.
+//!
+//! The binary format stores a header followed by the data in column-major
+//! order, such that the data can be used as an `Eigen::Map` without copying
+//! or parsing. The header consists of
+//!
+//! - the magic bytes `"VCLDATA"` followed by a zero byte,
+//! - the 64-bit integer `0x0102030405060708` (to detect files written on a
+//!   machine with different byte order),
+//! - the format version, the number of rows and the number of columns (each
+//!   a 64-bit unsigned integer),
+//! - one character per column containing its variable type (`'c'` for
+//!   continuous, `'d'` for discrete), padded with zeros to a multiple of 8
+//!   bytes.
+//!
+//! Files are mapped read-only on POSIX systems; on other platforms they are
+//! read into memory instead. The object must outlive all views on the data.
+class MappedData
+{
+public:
+  explicit MappedData(const std::string& filename);
+  ~MappedData();
+
+  MappedData(const MappedData&) = delete;
+  MappedData& operator=(const MappedData&) = delete;
+
+  Eigen::Map<const Eigen::MatrixXd> get_data() const;
+  std::vector<std::string> get_var_types() const;
+  size_t get_rows() const;
+  size_t get_cols() const;
+
+private:
+  void map_file(const std::string& filename);
+  void unmap_file();
+  void read_header(const std::string& filename);
+
+  const char* bytes_{ nullptr };
+  size_t num_bytes_{ 0 };
+  bool mapped_{ false };
+  std::vector<double> buffer_;
+  size_t rows_{ 0 };
+  size_t cols_{ 0 };
+  size_t offset_{ 0 };
+  std::vector<std::string> var_types_;
+};
+}
+}
+
+#include <vinecopulib/misc/implementation/tools_io.ipp>
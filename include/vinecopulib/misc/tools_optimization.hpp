@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <functional>
 
 namespace vinecopulib {
 
@@ -57,6 +58,14 @@ public:
     const Eigen::VectorXd& upper_bounds,
     std::function<double(const Eigen::VectorXd&)> objective);
 
+  Eigen::VectorXd optimize(
+    const Eigen::VectorXd& initial_parameters,
+    const Eigen::VectorXd& lower_bounds,
+    const Eigen::VectorXd& upper_bounds,
+    std::function<
+      double(const Eigen::VectorXd&, Eigen::VectorXd&, Eigen::MatrixXd&)>
+      objective_and_derivatives);
+
   size_t get_objective_calls() const;
   double get_objective_max() const;
 
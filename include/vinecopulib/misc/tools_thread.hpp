@@ -8,16 +8,81 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <future>
-#include <queue>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace vinecopulib {
 
 namespace tools_thread {
 
-//! Implemenation of the thread pool pattern based on `std::sthread`.
+//! A double-ended queue of jobs. The worker owning the queue pushes and pops
+//! jobs at the back, other workers steal jobs from the front.
+class TaskQueue
+{
+public:
+  void push(std::function<void()>&& job);
+  bool try_pop(std::function<void()>& job);
+  bool try_steal(std::function<void()>& job);
+
+private:
+  std::deque<std::function<void()>> jobs_;
+  std::mutex m_;
+};
+
+//! A pool of worker threads with one task queue per worker; idle workers
+//! steal jobs from the queues of other workers.
+//!
+//! The library uses a single, process-wide instance (see `global()`) that is
+//! created on first use and shared by all parallel computations.
+class WorkerPool
+{
+public:
+  WorkerPool(WorkerPool&&) = delete;
+  WorkerPool(const WorkerPool&) = delete;
+  explicit WorkerPool(size_t num_workers);
+
+  ~WorkerPool() noexcept;
+
+  WorkerPool& operator=(const WorkerPool&) = delete;
+  WorkerPool& operator=(WorkerPool&& other) = delete;
+
+  static WorkerPool& global();
+
+  size_t get_num_workers() const;
+  void push(std::function<void()>&& job);
+  bool try_run_job();
+
+private:
+  void run_worker(size_t id);
+  bool try_get_job(std::function<void()>& job);
+  ptrdiff_t get_worker_id() const;
+  static std::pair<const WorkerPool*, ptrdiff_t>& current_worker();
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> next_queue_{ 0 };
+
+  // variables for putting idle workers to sleep
+  std::mutex m_sleep_;
+  std::condition_variable cv_sleep_;
+  std::atomic<size_t> num_queued_{ 0 };
+  bool stopped_{ false };
+};
+
+//! Runs groups of jobs on the global worker pool.
+//!
+//! A `ThreadPool` does not own any threads. Jobs pushed to it are queued
+//! locally and processed by at most `num_threads - 1` workers of the global
+//! pool and the thread calling `wait()`. Because a thread waiting for its jobs
+//! processes them itself, nested parallel sections (e.g., pair-copula
+//! selection within vine selection) neither block nor spawn additional
+//! threads.
 class ThreadPool
 {
 public:
@@ -42,51 +107,255 @@ public:
   void clear();
 
 private:
-  void start_worker();
-  void do_job(std::function<void()>&& job);
-  void announce_busy();
-  void announce_idle();
-  void announce_stop();
-  void join_workers();
-
-  bool has_errored();
-  bool all_jobs_done();
-  bool wait_for_wake_up_event();
-  void rethrow_exceptions();
-
-  std::vector<std::thread> workers_;       // worker threads in the pool
-  std::queue<std::function<void()>> jobs_; // the task que
-
-  // variables for synchronization between workers
-  std::mutex m_tasks_;
-  std::condition_variable cv_tasks_;
-  std::condition_variable cv_busy_;
-  size_t num_busy_{ 0 };
-  bool stopped_{ false };
-  std::exception_ptr error_ptr_;
+  struct State
+  {
+    std::deque<std::function<void()>> jobs;
+    size_t num_running{ 0 };
+    size_t num_workers{ 0 };
+    std::exception_ptr error_ptr;
+    std::mutex m;
+    std::condition_variable cv;
+  };
+
+  void push_job(std::function<void()>&& job);
+  static void run_jobs(State& state, bool is_worker);
+  void wait_for_jobs();
+
+  size_t num_threads_;
+  std::shared_ptr<State> state_;
 };
 
-//! constructs a thread pool with as many workers as there are cores.
+//! configuration of the global worker pool.
+struct GlobalPoolConfig
+{
+  GlobalPoolConfig()
+    : num_threads(std::thread::hardware_concurrency())
+  {}
+
+  std::mutex m;
+  size_t num_threads;
+  bool created{ false };
+};
+
+inline GlobalPoolConfig&
+get_global_pool_config()
+{
+  static GlobalPoolConfig config;
+  return config;
+}
+
+//! @brief Sets the number of worker threads in the global pool.
+//!
+//! The pool is created the first time a parallel computation is run. The
+//! number of threads must be set before; by default, there are as many as
+//! hardware threads. The `num_threads` arguments of the library's functions
+//! limit how many of these threads a single call may use.
+//!
+//! @param num_threads The number of worker threads; if `0`, all work is done
+//!   by the calling threads.
+inline void
+set_global_num_threads(size_t num_threads)
+{
+  auto& config = get_global_pool_config();
+  std::lock_guard<std::mutex> lk(config.m);
+  if (config.created) {
+    throw std::runtime_error("the number of threads can only be set before "
+                             "the global thread pool is used.");
+  }
+  config.num_threads = num_threads;
+}
+
+//! @brief Returns the number of worker threads in the global pool.
+inline size_t
+get_global_num_threads()
+{
+  auto& config = get_global_pool_config();
+  std::lock_guard<std::mutex> lk(config.m);
+  return config.num_threads;
+}
+
+//! pushes a job to the back of the queue.
+inline void
+TaskQueue::push(std::function<void()>&& job)
+{
+  std::lock_guard<std::mutex> lk(m_);
+  jobs_.push_back(std::move(job));
+}
+
+//! takes the most recent job from the back of the queue.
+inline bool
+TaskQueue::try_pop(std::function<void()>& job)
+{
+  std::lock_guard<std::mutex> lk(m_);
+  if (jobs_.empty())
+    return false;
+  job = std::move(jobs_.back());
+  jobs_.pop_back();
+  return true;
+}
+
+//! takes the oldest job from the front of the queue.
+inline bool
+TaskQueue::try_steal(std::function<void()>& job)
+{
+  std::unique_lock<std::mutex> lk(m_, std::try_to_lock);
+  if (!lk.owns_lock() || jobs_.empty())
+    return false;
+  job = std::move(jobs_.front());
+  jobs_.pop_front();
+  return true;
+}
+
+//! constructs a worker pool with `num_workers` threads.
+//! @param num_workers Number of worker threads to create; if `0`, jobs
+//!   are only run by threads calling `try_run_job()`.
+inline WorkerPool::WorkerPool(size_t num_workers)
+{
+  for (size_t w = 0; w < std::max(num_workers, static_cast<size_t>(1)); ++w)
+    queues_.emplace_back(new TaskQueue);
+  for (size_t w = 0; w < num_workers; ++w)
+    workers_.emplace_back([this, w] { this->run_worker(w); });
+}
+
+//! destructor runs the remaining jobs and joins all threads.
+inline WorkerPool::~WorkerPool() noexcept
+{
+  // destructors should never throw
+  try {
+    {
+      std::lock_guard<std::mutex> lk(m_sleep_);
+      stopped_ = true;
+    }
+    cv_sleep_.notify_all();
+    for (auto& worker : workers_) {
+      if (worker.joinable())
+        worker.join();
+    }
+  } catch (...) {
+  }
+}
+
+//! returns the process-wide worker pool; it is created on first use with
+//! `get_global_num_threads()` workers.
+inline WorkerPool&
+WorkerPool::global()
+{
+  static WorkerPool pool([] {
+    auto& config = get_global_pool_config();
+    std::lock_guard<std::mutex> lk(config.m);
+    config.created = true;
+    return config.num_threads;
+  }());
+  return pool;
+}
+
+//! returns the number of worker threads.
+inline size_t
+WorkerPool::get_num_workers() const
+{
+  return workers_.size();
+}
+
+//! pushes a job to the pool; jobs pushed by a worker go to its own queue,
+//! other jobs are distributed over the queues in turn.
+inline void
+WorkerPool::push(std::function<void()>&& job)
+{
+  ptrdiff_t id = this->get_worker_id();
+  size_t q = (id >= 0) ? static_cast<size_t>(id)
+                       : next_queue_++ % queues_.size();
+  queues_[q]->push(std::move(job));
+  {
+    // must hold the lock while announcing new work to avoid lost wake ups
+    std::lock_guard<std::mutex> lk(m_sleep_);
+    ++num_queued_;
+  }
+  cv_sleep_.notify_one();
+}
+
+//! runs a job from the pool's queues (if there is one).
+//! @return `true` if a job was run.
+inline bool
+WorkerPool::try_run_job()
+{
+  std::function<void()> job;
+  if (!try_get_job(job))
+    return false;
+  job();
+  return true;
+}
+
+//! takes a job from the worker's own queue or steals one from another queue.
+inline bool
+WorkerPool::try_get_job(std::function<void()>& job)
+{
+  if (num_queued_ == 0)
+    return false;
+  ptrdiff_t id = this->get_worker_id();
+  size_t start = (id >= 0) ? static_cast<size_t>(id) : 0;
+  bool found = (id >= 0) && queues_[start]->try_pop(job);
+  // a failed steal may be due to contention, so try a few rounds
+  for (size_t k = 0; !found && (k < 2 * queues_.size()); ++k) {
+    found = queues_[(start + k) % queues_.size()]->try_steal(job);
+  }
+  if (found)
+    --num_queued_;
+  return found;
+}
+
+//! loop run by the worker threads; workers sleep while there are no jobs
+//! and only stop after all jobs are done.
+inline void
+WorkerPool::run_worker(size_t id)
+{
+  current_worker() = std::make_pair(this, static_cast<ptrdiff_t>(id));
+  while (true) {
+    if (this->try_run_job())
+      continue;
+    std::unique_lock<std::mutex> lk(m_sleep_);
+    cv_sleep_.wait(lk, [this] { return stopped_ || (num_queued_ > 0); });
+    if (stopped_ && (num_queued_ == 0))
+      return;
+  }
+}
+
+//! index of the worker running in the calling thread (`-1` for threads
+//! outside the pool).
+inline ptrdiff_t
+WorkerPool::get_worker_id() const
+{
+  auto& worker = current_worker();
+  return (worker.first == this) ? worker.second : -1;
+}
+
+//! pool and index of the worker running in the calling thread.
+inline std::pair<const WorkerPool*, ptrdiff_t>&
+WorkerPool::current_worker()
+{
+  static thread_local std::pair<const WorkerPool*, ptrdiff_t> worker(nullptr,
+                                                                      -1);
+  return worker;
+}
+
+//! constructs a thread pool using as many threads as there are cores.
 inline ThreadPool::ThreadPool()
   : ThreadPool(std::thread::hardware_concurrency())
 {}
 
-//! constructs a thread pool with `nThreads` threads.
-//! @param nWorkers Number of worker threads to create; if `nThreads = 0`, all
-//!    work pushed to the pool will be done in the main thread.
-inline ThreadPool::ThreadPool(size_t nWorkers)
-{
-  for (size_t w = 0; w < nWorkers; ++w)
-    this->start_worker();
-}
+//! constructs a thread pool using at most `nThreads` threads.
+//! @param nThreads Number of threads to use; if `nThreads = 0`, all work
+//!    pushed to the pool will be done in the calling thread.
+inline ThreadPool::ThreadPool(size_t nThreads)
+  : num_threads_(nThreads)
+  , state_(std::make_shared<State>())
+{}
 
-//! destructor joins all threads if possible.
+//! destructor waits for all jobs to finish.
 inline ThreadPool::~ThreadPool() noexcept
 {
   // destructors should never throw
   try {
-    this->announce_stop();
-    this->join_workers();
+    this->wait_for_jobs();
   } catch (...) {
   }
 }
@@ -101,18 +370,11 @@ template<class F, class... Args>
 void
 ThreadPool::push(F&& f, Args&&... args)
 {
-  if (workers_.size() == 0) {
+  if (num_threads_ == 0) {
     f(args...); // if there are no workers, do the job in the main thread
     return;
-  } else {
-    // must hold lock while modifying the shared queue
-    std::lock_guard<std::mutex> lk(m_tasks_);
-    if (stopped_)
-      throw std::runtime_error("cannot push to joined thread pool");
-    jobs_.emplace([f, args...] { f(args...); });
   }
-  // signal a waiting worker that there's a new job
-  cv_tasks_.notify_one();
+  this->push_job([f, args...] { f(args...); });
 }
 
 //! maps a function on a list of items, possibly running tasks in parallel.
@@ -128,167 +390,107 @@ ThreadPool::map(F&& f, I&& items)
     this->push(f, item);
 }
 
-//! waits for all jobs to finish, but does not join the threads.
+//! waits for all jobs to finish; the calling thread helps running them.
 inline void
 ThreadPool::wait()
 {
-  while (true) {
-    if (wait_for_wake_up_event()) {
-      if (!this->all_jobs_done()) {
-        this->clear(); // cancel all remaining jobs
-        continue;      // wait for currently running jobs
-      }
-      if (this->has_errored() | this->all_jobs_done())
-        break;
-    }
-    std::this_thread::yield();
+  this->wait_for_jobs();
+  std::exception_ptr error_ptr;
+  {
+    std::lock_guard<std::mutex> lk(state_->m);
+    std::swap(error_ptr, state_->error_ptr);
   }
-
-  this->rethrow_exceptions();
+  if (error_ptr)
+    std::rethrow_exception(error_ptr);
 }
 
-//! waits for all jobs to finish and joins all threads.
+//! waits for all jobs to finish (there are no threads to join).
 inline void
 ThreadPool::join()
 {
   this->wait();
-  this->announce_stop();
-  this->join_workers();
 }
 
 //! clears the pool from all open jobs.
 inline void
 ThreadPool::clear()
 {
-  // must hold lock while modifying job queue
-  std::lock_guard<std::mutex> lk(m_tasks_);
-  std::queue<std::function<void()>>().swap(jobs_);
-  cv_tasks_.notify_all();
-}
-
-//! spawns a worker thread waiting for jobs to arrive.
-inline void
-ThreadPool::start_worker()
-{
-  workers_.emplace_back([this] {
-    std::function<void()> job;
-    // observe thread pool; only stop after all jobs are done
-    while ((!stopped_) | (!jobs_.empty())) {
-      // must hold a lock while modifying shared variables
-      std::unique_lock<std::mutex> lk(m_tasks_);
-
-      // thread should wait when there is no job
-      cv_tasks_.wait(lk, [this] { return stopped_ || !jobs_.empty(); });
-
-      // queue can be empty if thread pool is stopped
-      if (jobs_.empty())
-        continue;
-
-      // take job from the queue
-      job = std::move(jobs_.front());
-      jobs_.pop();
-
-      // lock can be released before starting work, but must signal
-      // that thread will be busy before (!) to avoid premature breaks
-      this->announce_busy();
-      lk.unlock();
-
-      this->do_job(std::move(job));
-      this->announce_idle();
-      std::this_thread::yield();
-    }
-  });
-}
-
-//! executes a job safely and let's pool know when it's busy.
-//! @param job Job to be exectued.
-inline void
-ThreadPool::do_job(std::function<void()>&& job)
-{
-  try {
-    job();
-  } catch (...) {
-    std::lock_guard<std::mutex> lk(m_tasks_);
-    error_ptr_ = std::current_exception();
-  }
+  std::lock_guard<std::mutex> lk(state_->m);
+  state_->jobs.clear();
+  state_->cv.notify_all();
 }
 
-//! signals that a worker is busy (must be called why locking m_tasks_).
+//! queues a job and, if the limit isn't reached yet, asks another worker of
+//! the global pool to help with processing the queue.
 inline void
-ThreadPool::announce_busy()
-{
-  ++num_busy_;
-  cv_busy_.notify_one();
-}
-
-//! signals that a worker is idle.
-inline void
-ThreadPool::announce_idle()
+ThreadPool::push_job(std::function<void()>&& job)
 {
+  auto& pool = WorkerPool::global();
+  bool add_worker;
   {
-    std::lock_guard<std::mutex> lk(m_tasks_);
-    --num_busy_;
+    std::lock_guard<std::mutex> lk(state_->m);
+    state_->jobs.push_back(std::move(job));
+    size_t max_workers = std::min(num_threads_ - 1, pool.get_num_workers());
+    add_worker = (state_->num_workers < max_workers);
+    if (add_worker)
+      ++state_->num_workers;
   }
-  cv_busy_.notify_one();
-}
-
-//! signals threads that no more new work is coming.
-inline void
-ThreadPool::announce_stop()
-{
-  {
-    std::unique_lock<std::mutex> lk(m_tasks_);
-    stopped_ = true;
+  if (add_worker) {
+    // the state is shared, because the worker may start after the pool is
+    // gone (and find no more jobs)
+    auto state = state_;
+    pool.push([state] { run_jobs(*state, true); });
   }
-  cv_tasks_.notify_all();
 }
 
-//! joins worker threads if possible.
+//! processes jobs from the queue until it is empty; if a job throws, the
+//! remaining jobs are cancelled.
+//! @param state The state of the pool.
+//! @param is_worker Whether the function is run by a worker that was
+//!   requested in `push_job()`.
 inline void
-ThreadPool::join_workers()
+ThreadPool::run_jobs(State& state, bool is_worker)
 {
-  if (workers_.size() > 0) {
-    for (auto& worker : workers_) {
-      if (worker.joinable())
-        worker.join();
+  std::function<void()> job;
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lk(state.m);
+      if (state.jobs.empty()) {
+        // must be announced under the same lock, so that `push_job()`
+        // requests a new worker if jobs are added later
+        if (is_worker)
+          --state.num_workers;
+        return;
+      }
+      job = std::move(state.jobs.front());
+      state.jobs.pop_front();
+      ++state.num_running;
+    }
+    std::exception_ptr error_ptr;
+    try {
+      job();
+    } catch (...) {
+      error_ptr = std::current_exception();
+    }
+    std::lock_guard<std::mutex> lk(state.m);
+    if (error_ptr) {
+      state.error_ptr = error_ptr;
+      state.jobs.clear();
     }
+    if ((--state.num_running == 0) && state.jobs.empty())
+      state.cv.notify_all();
   }
 }
 
-//! checks if an error occured.
-inline bool
-ThreadPool::has_errored()
-{
-  return static_cast<bool>(error_ptr_);
-}
-
-//! check whether all jobs are done
-inline bool
-ThreadPool::all_jobs_done()
-{
-  return (num_busy_ == 0) && jobs_.empty();
-}
-
-//! checks whether `wait()` needs to wake up
-inline bool
-ThreadPool::wait_for_wake_up_event()
-{
-  static auto timeout = std::chrono::milliseconds(250);
-  auto wake_up_event_occured = [this] {
-    return this->all_jobs_done() | this->has_errored();
-  };
-  std::unique_lock<std::mutex> lk(m_tasks_);
-  cv_busy_.wait_for(lk, timeout, wake_up_event_occured);
-  return wake_up_event_occured();
-}
-
-//! rethrows exceptions (exceptions from workers are caught and stored; the
-//! wait loop only checks, but does not throw exceptions)
+//! helps running queued jobs and waits for running jobs to finish.
 inline void
-ThreadPool::rethrow_exceptions()
+ThreadPool::wait_for_jobs()
 {
-  if (this->has_errored())
-    std::rethrow_exception(error_ptr_);
+  run_jobs(*state_, false);
+  std::unique_lock<std::mutex> lk(state_->m);
+  state_->cv.wait(lk, [this] {
+    return (state_->num_running == 0) && state_->jobs.empty();
+  });
 }
 
 }
@@ -0,0 +1,70 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace vinecopulib {
+
+//! @brief A variable type identifier.
+//!
+//! The public interface specifies variable types as strings (`"c"` for
+//! continuous, `"d"` for discrete); they are converted to this compact
+//! representation once and used internally.
+enum class VarType : unsigned char
+{
+  continuous = 0, ///< continuous variable (`"c"`)
+  discrete = 1    ///< discrete variable (`"d"`)
+};
+
+//! @brief The types of the two variables of a pair-copula.
+//!
+//! The value is a bitmask: bit `i` is set if variable `i` is discrete.
+enum class VarTypePair : unsigned char
+{
+  cc = 0, ///< both variables continuous
+  dc = 1, ///< first variable discrete, second continuous
+  cd = 2, ///< first variable continuous, second discrete
+  dd = 3  ///< both variables discrete
+};
+
+std::string
+get_var_type_name(VarType type);
+
+VarType
+get_var_type_enum(const std::string& type);
+
+std::vector<std::string>
+get_var_type_names(const std::vector<VarType>& types);
+
+std::vector<VarType>
+get_var_type_enums(const std::vector<std::string>& types);
+
+VarTypePair
+get_var_type_pair(VarType type1, VarType type2);
+
+VarTypePair
+get_var_type_pair(const std::vector<std::string>& types);
+
+std::vector<std::string>
+get_var_type_names(VarTypePair types);
+
+VarType
+get_var_type(VarTypePair types, size_t i);
+
+bool
+is_discrete(VarTypePair types, size_t i);
+
+unsigned short
+count_discrete(VarTypePair types);
+
+VarTypePair
+flip_var_types(VarTypePair types);
+}
+
+#include <vinecopulib/misc/implementation/var_types.ipp>
@@ -7,7 +7,12 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <functional>
+#include <memory>
+#include <vinecopulib/misc/dominance_index.hpp>
+#include <vinecopulib/vinecop/evaluation_plan.hpp>
 #include <vinecopulib/vinecop/fit_controls.hpp>
+#include <vinecopulib/vinecop/gaussian_plan.hpp>
 #include <vinecopulib/vinecop/rvine_structure.hpp>
 
 namespace vinecopulib {
@@ -22,6 +27,10 @@ class VinecopSelector;
 //!
 //! A vine copula model is characterized by its structure (see
 //! `RVineStructure` objects) and the pair-copulas.
+//!
+//! Const methods do not modify the model, so a single object can be
+//! evaluated (e.g., by `pdf()`, `cdf()`, or `simulate()`) from several
+//! threads concurrently.
 class Vinecop
 {
 public:
@@ -118,23 +127,40 @@ public:
   double get_mbicv(const double psi0 = 0.9) const;
 
   // Stats methods
-  Eigen::VectorXd pdf(Eigen::MatrixXd u, const size_t num_threads = 1) const;
+  Eigen::VectorXd pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                      const size_t num_threads = 1) const;
+
+  Eigen::VectorXd logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                         const size_t num_threads = 1) const;
 
-  Eigen::VectorXd cdf(const Eigen::MatrixXd& u,
+  void pdf_chunked(const std::function<bool(Eigen::MatrixXd&)>& source,
+                   const std::function<void(const Eigen::VectorXd&)>& sink,
+                   const size_t num_threads = 1) const;
+
+  Eigen::VectorXd cdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
                       const size_t N = 1e4,
                       const size_t num_threads = 1,
                       std::vector<int> seeds = std::vector<int>()) const;
 
+  Eigen::MatrixXd cdf_adaptive(
+    const Eigen::Ref<const Eigen::MatrixXd>& u,
+    const double abs_tol = 1e-3,
+    const double rel_tol = 0.0,
+    const size_t N_max = 1e6,
+    const size_t num_threads = 1,
+    std::vector<int> seeds = std::vector<int>()) const;
+
   Eigen::MatrixXd simulate(
     const size_t n,
     const bool qrng = false,
     const size_t num_threads = 1,
     const std::vector<int>& seeds = std::vector<int>()) const;
 
-  Eigen::MatrixXd rosenblatt(const Eigen::MatrixXd& u,
+  Eigen::MatrixXd rosenblatt(const Eigen::Ref<const Eigen::MatrixXd>& u,
                              const size_t num_threads = 1) const;
-  Eigen::MatrixXd inverse_rosenblatt(const Eigen::MatrixXd& u,
-                                     const size_t num_threads = 1) const;
+  Eigen::MatrixXd inverse_rosenblatt(
+    const Eigen::Ref<const Eigen::MatrixXd>& u,
+    const size_t num_threads = 1) const;
 
   void set_all_pair_copulas(
     const std::vector<std::vector<Bicop>>& pair_copulas);
@@ -145,16 +171,19 @@ public:
   // Fit statistics
   double get_npars() const;
 
-  double loglik(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
+  double loglik(const Eigen::Ref<const Eigen::MatrixXd>& u = Eigen::MatrixXd(),
                 const size_t num_threads = 1) const;
 
-  double aic(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
+  double loglik_chunked(const std::function<bool(Eigen::MatrixXd&)>& source,
+                        const size_t num_threads = 1) const;
+
+  double aic(const Eigen::Ref<const Eigen::MatrixXd>& u = Eigen::MatrixXd(),
              const size_t num_threads = 1) const;
 
-  double bic(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
+  double bic(const Eigen::Ref<const Eigen::MatrixXd>& u = Eigen::MatrixXd(),
              const size_t num_threads = 1) const;
 
-  double mbicv(const Eigen::MatrixXd& u = Eigen::MatrixXd(),
+  double mbicv(const Eigen::Ref<const Eigen::MatrixXd>& u = Eigen::MatrixXd(),
                const double psi0 = 0.9,
                const size_t num_threads = 1) const;
 
@@ -169,14 +198,28 @@ public:
 protected:
   size_t d_;
   RVineStructure rvine_structure_;
-  mutable std::vector<std::vector<Bicop>> pair_copulas_;
+  std::vector<std::vector<Bicop>> pair_copulas_;
   double threshold_{ 0.0 };
   double loglik_{ NAN };
   size_t nobs_{ 0 };
-  mutable std::vector<std::string> var_types_;
-
-  void check_data_dim(const Eigen::MatrixXd& data) const;
-  void check_data(const Eigen::MatrixXd& data) const;
+  std::vector<VarType> var_types_;
+  EvaluationPlan plan_;
+  //! only compiled if all pair-copulas are Gaussian or independent
+  GaussianPlan gaussian_plan_;
+
+  //! quasi-random sample used by `cdf()`, cached for repeated calls (the
+  //! only state modified by const methods; accessed atomically)
+  struct CdfSample
+  {
+    size_t N;
+    std::vector<int> seeds;
+    DominanceIndex index;
+  };
+  mutable std::shared_ptr<const CdfSample> cdf_sample_;
+
+  void check_data_dim(const Eigen::Ref<const Eigen::MatrixXd>& data) const;
+  void check_data(const Eigen::Ref<const Eigen::MatrixXd>& data) const;
+  void check_cdf_dim() const;
   void check_pair_copulas_rvine_structure(
     const std::vector<std::vector<Bicop>>& pair_copulas) const;
   double calculate_mbicv_penalty(const size_t nobs, const double psi0) const;
@@ -187,10 +230,28 @@ protected:
   void check_fitted() const;
   void check_indices(const size_t tree, const size_t edge) const;
   void check_var_types(const std::vector<std::string>& var_types) const;
-  void set_continuous_var_types() const;
-  void set_var_types_internal(const std::vector<std::string>& var_types) const;
+  void set_continuous_var_types();
+  void set_var_types_internal(const std::vector<VarType>& var_types);
+  void compile();
+  Eigen::MatrixXd simulate_from_uniform(const Eigen::MatrixXd& u,
+                                        const size_t num_threads) const;
   int get_n_discrete() const;
-  Eigen::MatrixXd collapse_data(const Eigen::MatrixXd& u) const;
+  Eigen::MatrixXd collapse_data(
+    const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+  void evaluate_pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                    Eigen::VectorXd& pdf,
+                    EvaluationScratchPool& scratch,
+                    const size_t num_threads,
+                    const bool log = false) const;
+  void evaluate_pdf_chunked(
+    const std::function<bool(Eigen::MatrixXd&)>& source,
+    const std::function<void(const Eigen::VectorXd&)>& sink,
+    const size_t num_threads,
+    const bool log) const;
+  Eigen::MatrixXd evaluate_inverse_rosenblatt(
+    const Eigen::Ref<const Eigen::MatrixXd>& u,
+    const std::vector<std::vector<Bicop>>& pair_copulas,
+    const size_t num_threads) const;
 };
 }
 
@@ -0,0 +1,122 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <vinecopulib/misc/var_types.hpp>
+#include <vinecopulib/vinecop/rvine_structure.hpp>
+
+namespace vinecopulib {
+
+//! @brief A single instruction of an `EvaluationPlan`.
+//!
+//! Describes how the pair-copula of edge `edge` in tree `tree` is fed and
+//! which h-functions it must emit. The first argument of the pair-copula is
+//! always stored in column `edge` of the `hfunc2` matrix (of the previous
+//! tree); the second argument is stored in column `arg_col` of either the
+//! `hfunc2` or the `hfunc1` matrix.
+//!
+//! For the independence copula, the density is one and the h-functions
+//! return the other argument. Such steps can be short-circuited: `hfunc2`
+//! stays in place (column `edge` already holds the first argument) and
+//! `hfunc1` is a copy of the second argument. The flags `live_hfunc1` and
+//! `live_hfunc2` tell which h-functions are still needed when all
+//! independence steps are short-circuited; they are false for steps whose
+//! values are only passed on to independence steps that do not need them.
+struct EvaluationStep
+{
+  size_t tree;        //!< the tree index.
+  size_t edge;        //!< the edge index.
+  size_t arg_col;     //!< column holding the second argument.
+  bool arg_hfunc2;    //!< whether the second argument is a `hfunc2` value.
+  bool needs_hfunc1;  //!< whether `hfunc1` is needed in the next tree.
+  bool needs_hfunc2;  //!< whether `hfunc2` is needed in the next tree.
+  bool disc1;         //!< whether the first variable is discrete.
+  bool disc2;         //!< whether the second variable is discrete.
+  bool indep;         //!< whether the pair-copula is the independence copula.
+  bool live_hfunc1;   //!< `needs_hfunc1` with short-circuited independence.
+  bool live_hfunc2;   //!< `needs_hfunc2` with short-circuited independence.
+};
+
+//! @brief A precompiled evaluation plan for vine copula models.
+//!
+//! The plan flattens an `RVineStructure` (and the variable types) into a
+//! linear list of `EvaluationStep`s, ordered by tree and edge. Algorithms
+//! walking through the vine (such as `Vinecop::pdf()`,
+//! `Vinecop::rosenblatt()`, or `Vinecop::inverse_rosenblatt()`) can run the
+//! plan directly instead of querying the structure and comparing variable
+//! types for every edge and every batch.
+class EvaluationPlan
+{
+public:
+  EvaluationPlan() {}
+  EvaluationPlan(const RVineStructure& structure,
+                 const std::vector<VarType>& var_types = {},
+                 const std::vector<std::vector<bool>>& indep = {});
+
+  size_t get_dim() const;
+  size_t get_trunc_lvl() const;
+  bool has_discrete() const;
+
+  const std::vector<size_t>& get_input_cols() const;
+  const std::vector<ptrdiff_t>& get_input_sub_cols() const;
+  const std::vector<size_t>& get_output_cols() const;
+
+  const std::vector<EvaluationStep>& get_steps() const;
+  const EvaluationStep& get_step(size_t tree, size_t edge) const;
+
+private:
+  size_t d_{ 0 };
+  size_t trunc_lvl_{ 0 };
+  bool has_discrete_{ false };
+  std::vector<size_t> input_cols_;
+  std::vector<ptrdiff_t> input_sub_cols_;
+  std::vector<size_t> output_cols_;
+  std::vector<EvaluationStep> steps_;
+  std::vector<size_t> tree_offsets_;
+};
+
+//! @brief Temporary storage for running an `EvaluationPlan` on a batch of
+//! rows.
+//!
+//! The matrices have (at least) as many rows as the batch; algorithms work on
+//! their top rows, so that the storage can be reused for smaller batches.
+struct EvaluationScratch
+{
+  Eigen::MatrixXd hfunc1;     //!< h-functions (first argument).
+  Eigen::MatrixXd hfunc2;     //!< h-functions (second argument).
+  Eigen::MatrixXd hfunc1_sub; //!< left-sided limits of `hfunc1`.
+  Eigen::MatrixXd hfunc2_sub; //!< left-sided limits of `hfunc2`.
+  Eigen::MatrixXd u_e;        //!< arguments of continuous pair-copulas.
+  Eigen::MatrixXd u_e_disc;   //!< arguments of discrete pair-copulas.
+  Eigen::VectorXd values_e;   //!< values of a pair-copula.
+
+  void reserve(size_t rows, size_t d, bool has_discrete);
+};
+
+//! @brief A set of `EvaluationScratch` objects shared by concurrent batches.
+//!
+//! Each batch takes a scratch object and returns it when done, so the number
+//! of objects (and the memory) is bounded by the number of concurrent
+//! batches, and the storage is reused across batches and calls.
+class EvaluationScratchPool
+{
+public:
+  std::unique_ptr<EvaluationScratch> acquire();
+  void release(std::unique_ptr<EvaluationScratch>&& scratch);
+
+private:
+  std::vector<std::unique_ptr<EvaluationScratch>> free_;
+  std::mutex m_;
+};
+}
+
+#include <vinecopulib/vinecop/implementation/evaluation_plan.ipp>
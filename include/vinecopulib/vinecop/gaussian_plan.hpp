@@ -0,0 +1,66 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+#include <vinecopulib/vinecop/evaluation_plan.hpp>
+
+namespace vinecopulib {
+
+//! @brief An evaluation plan for Gaussian vine copula models.
+//!
+//! If all pair-copulas are Gaussian or independence copulas, the vine is a
+//! multivariate Gaussian copula and the parameters are partial correlations.
+//! With \f$ z = \Phi^{-1}(u) \f$, the conditional variables of the vine are
+//! then standardized residuals of linear regressions: the h-functions of an
+//! edge with parameter \f$ \rho \f$ map two residuals \f$ a, b \f$ to
+//! \f$ (b - \rho a) / \sqrt{1 - \rho^2} \f$ and
+//! \f$ (a - \rho b) / \sqrt{1 - \rho^2} \f$. Running an `EvaluationPlan` on
+//! coefficient vectors instead of data gives a lower triangular matrix
+//! \f$ C \f$ (in natural order), such that \f$ w = z C \f$ are the
+//! independent standard normal variables underlying the Rosenblatt
+//! transform.
+//!
+//! The density, the Rosenblatt transform, and its inverse then cost one
+//! quantile transform, one triangular matrix product (or solve), and (for
+//! the transforms) one distribution transform per observation instead of a
+//! pass over all pair-copulas. For truncated vines, \f$ C \f$ (and, hence,
+//! the precision matrix \f$ C C^\top \f$) is sparse with at most
+//! \f$ t + 1 \f$ non-zero entries per column, where \f$ t \f$ is the
+//! truncation level; it is then stored column-wise.
+class GaussianPlan
+{
+public:
+  GaussianPlan() {}
+  GaussianPlan(const EvaluationPlan& plan,
+               const std::vector<std::vector<double>>& rho);
+
+  size_t get_dim() const;
+
+  Eigen::VectorXd pdf(const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+  Eigen::VectorXd logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+  Eigen::MatrixXd rosenblatt(const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+  Eigen::MatrixXd inverse_rosenblatt(
+    const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+
+private:
+  Eigen::MatrixXd to_normal(const Eigen::Ref<const Eigen::MatrixXd>& u) const;
+  Eigen::MatrixXd whiten(const Eigen::MatrixXd& z) const;
+  Eigen::MatrixXd unwhiten(const Eigen::MatrixXd& w) const;
+
+  size_t d_{ 0 };
+  bool dense_{ true };
+  Eigen::MatrixXd coefs_;       //!< the matrix \f$ C \f$ (if dense).
+  std::vector<size_t> starts_;  //!< start of each column (if sparse).
+  std::vector<size_t> rows_;    //!< row of each non-zero (diagonal first).
+  std::vector<double> values_;  //!< value of each non-zero.
+  double log_det_{ 0.0 };       //!< log-determinant of the correlation.
+};
+}
+
+#include <vinecopulib/vinecop/implementation/gaussian_plan.ipp>
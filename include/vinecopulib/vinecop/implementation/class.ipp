@@ -11,6 +11,8 @@
 #include <vinecopulib/misc/tools_stl.hpp>
 #include <vinecopulib/vinecop/tools_select.hpp>
 
+#include <future>
+#include <random>
 #include <stdexcept>
 
 namespace vinecopulib {
@@ -151,14 +153,20 @@ inline Vinecop::Vinecop(const boost::property_tree::ptree input,
   }
 
   // try block for backwards compatibility
+  std::vector<std::string> var_types;
   try {
-    var_types_ = tools_serialization::ptree_to_vector<std::string>(
+    var_types = tools_serialization::ptree_to_vector<std::string>(
       input.get_child("var_types"));
     nobs_ = input.get<size_t>("nobs_");
     threshold_ = input.get<double>("threshold");
     loglik_ = input.get<double>("loglik");
   } catch (...) {
   }
+  if (var_types.size() == d_) {
+    set_var_types_internal(get_var_type_enums(var_types));
+  } else {
+    set_continuous_var_types();
+  }
 }
 
 //! @brief Instantiates from a JSON file.
@@ -208,7 +216,7 @@ Vinecop::to_ptree() const
   auto structure_node = rvine_structure_.to_ptree();
   output.add_child("structure", structure_node);
   output.add_child("var_types",
-                   tools_serialization::vector_to_ptree(var_types_));
+                   tools_serialization::vector_to_ptree(get_var_types()));
   output.put("nobs_", nobs_);
   output.put("threshold", threshold_);
   output.put("loglik", loglik_);
@@ -652,7 +660,7 @@ inline void
 Vinecop::set_var_types(const std::vector<std::string>& var_types)
 {
   check_var_types(var_types);
-  set_var_types_internal(var_types);
+  set_var_types_internal(get_var_type_enums(var_types));
 }
 
 //! @brief Sets all pair-copulas.
@@ -665,6 +673,12 @@ Vinecop::set_all_pair_copulas(
   check_pair_copulas_rvine_structure(pair_copulas);
   pair_copulas_ = pair_copulas;
   rvine_structure_.truncate(pair_copulas.size());
+  if (var_types_.size() == d_) {
+    // keeps the pair-copulas' variable types consistent with the model
+    set_var_types_internal(var_types_);
+  } else {
+    compile();
+  }
 }
 
 inline void
@@ -689,36 +703,34 @@ Vinecop::check_var_types(const std::vector<std::string>& var_types) const
 //! @param var_types A vector specifying the types of the variables,
 //!   e.g., `{"c", "d"}` means first varible continuous, second discrete.
 inline void
-Vinecop::set_var_types_internal(const std::vector<std::string>& var_types) const
+Vinecop::set_var_types_internal(const std::vector<VarType>& var_types)
 {
   var_types_ = var_types;
+  compile();
   if (pair_copulas_.size() == 0) {
     return;
   }
 
   // set new var_types for all pair-copulas
-  std::vector<std::string> natural_types(d_), pair_types(2);
+  std::vector<VarType> natural_types(d_);
   for (size_t j = 0; j < d_; ++j) {
     natural_types[j] = var_types[rvine_structure_.get_order()[j] - 1];
   }
   // we set the first tree explicitly and deduce later trees
   for (size_t e = 0; e < d_ - 1; ++e) {
-    pair_types[0] = natural_types[e];
-    pair_types[1] =
-      natural_types[rvine_structure_.struct_array(0, e, true) - 1];
-    pair_copulas_[0][e].set_var_types(pair_types);
+    pair_copulas_[0][e].set_var_type_pair(get_var_type_pair(
+      natural_types[e],
+      natural_types[rvine_structure_.struct_array(0, e, true) - 1]));
   }
 
   for (size_t t = 1; t < pair_copulas_.size(); ++t) {
     for (size_t e = 0; e < d_ - t - 1; ++e) {
       size_t m = rvine_structure_.min_array(t, e);
-      pair_types[0] = pair_copulas_[t - 1][e].get_var_types()[0];
-      if (m == rvine_structure_.struct_array(t, e, true)) {
-        pair_types[1] = pair_copulas_[t - 1][m - 1].get_var_types()[0];
-      } else {
-        pair_types[1] = pair_copulas_[t - 1][m - 1].get_var_types()[1];
-      }
-      pair_copulas_[t][e].set_var_types(pair_types);
+      bool is_first = (m == rvine_structure_.struct_array(t, e, true));
+      auto types1 = pair_copulas_[t - 1][e].get_var_type_pair();
+      auto types2 = pair_copulas_[t - 1][m - 1].get_var_type_pair();
+      pair_copulas_[t][e].set_var_type_pair(get_var_type_pair(
+        get_var_type(types1, 0), get_var_type(types2, is_first ? 0 : 1)));
     }
   }
 }
@@ -727,7 +739,7 @@ Vinecop::set_var_types_internal(const std::vector<std::string>& var_types) const
 inline std::vector<std::string>
 Vinecop::get_var_types() const
 {
-  return var_types_;
+  return get_var_type_names(var_types_);
 }
 
 //! @}
@@ -744,90 +756,246 @@ Vinecop::get_var_types() const
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline Eigen::VectorXd
-Vinecop::pdf(Eigen::MatrixXd u, const size_t num_threads) const
+Vinecop::pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+             const size_t num_threads) const
 {
   check_data(u);
-  u = collapse_data(u);
+  Eigen::VectorXd pdf(u.rows());
+  EvaluationScratchPool scratch;
+  if (static_cast<size_t>(u.cols()) == d_ + get_n_discrete()) {
+    evaluate_pdf(u, pdf, scratch, num_threads);
+  } else {
+    evaluate_pdf(collapse_data(u), pdf, scratch, num_threads);
+  }
 
-  // info about the vine structure (reverse rows (!) for more natural indexing)
-  size_t trunc_lvl = rvine_structure_.get_trunc_lvl();
-  auto order = rvine_structure_.get_order();
-  auto disc_cols = tools_select::get_disc_cols(var_types_);
+  return pdf;
+}
+
+//! @brief Evaluates the logarithm of the copula density.
+//!
+//! The log-density is accumulated as a sum of the pair-copula log-densities,
+//! so it remains finite in high dimensions where `pdf()` under- or overflows.
+//!
+//! @param u An \f$ n \times (d + k) \f$ or \f$ n \times 2d \f$ matrix of
+//!   evaluation points, where \f$ k \f$ is the number of discrete variables
+//!   (see `select()`).
+//! @param num_threads The number of threads to use for computations; if greater
+//!   than 1, the function will be applied concurrently to `num_threads` batches
+//!   of `u`.
+inline Eigen::VectorXd
+Vinecop::logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                const size_t num_threads) const
+{
+  check_data(u);
+  Eigen::VectorXd logpdf(u.rows());
+  EvaluationScratchPool scratch;
+  if (static_cast<size_t>(u.cols()) == d_ + get_n_discrete()) {
+    evaluate_pdf(u, logpdf, scratch, num_threads, true);
+  } else {
+    evaluate_pdf(collapse_data(u), logpdf, scratch, num_threads, true);
+  }
 
-  // initial value must be 1.0 for multiplication
-  Eigen::VectorXd pdf = Eigen::VectorXd::Constant(u.rows(), 1.0);
+  return logpdf;
+}
+
+//! @brief Evaluates the copula density on data that is read in chunks.
+//!
+//! The data is requested from `source` chunk by chunk; the next chunk is read
+//! (in a separate thread) while the current one is evaluated. The densities
+//! of each chunk are passed to `sink` (in the calling thread). Memory is
+//! bounded by two chunks and the temporary storage of the evaluation, which
+//! is reused across chunks.
+//!
+//! @param source A function that fills its argument with the next chunk of
+//!   evaluation points (see `pdf()` for the format) and returns `false` when
+//!   there is no more data. It is never called concurrently, but not
+//!   necessarily from the calling thread.
+//! @param sink A function that is called with the densities of each chunk,
+//!   in the order of the chunks.
+//! @param num_threads The number of threads to use for evaluating each
+//!   chunk.
+inline void
+Vinecop::pdf_chunked(const std::function<bool(Eigen::MatrixXd&)>& source,
+                     const std::function<void(const Eigen::VectorXd&)>& sink,
+                     const size_t num_threads) const
+{
+  evaluate_pdf_chunked(source, sink, num_threads, false);
+}
+
+//! @brief Evaluates the copula density (or its logarithm) on data that is
+//! read in chunks, see `pdf_chunked()`.
+inline void
+Vinecop::evaluate_pdf_chunked(
+  const std::function<bool(Eigen::MatrixXd&)>& source,
+  const std::function<void(const Eigen::VectorXd&)>& sink,
+  const size_t num_threads,
+  const bool log) const
+{
+  Eigen::MatrixXd chunk, next_chunk;
+  Eigen::VectorXd pdf;
+  EvaluationScratchPool scratch;
+  bool has_chunk = source(chunk);
+  while (has_chunk) {
+    // read the next chunk while the current one is evaluated
+    auto read_next = [&source, &next_chunk] { return source(next_chunk); };
+    auto reader = std::async(std::launch::async, read_next);
+    check_data(chunk);
+    pdf.resize(chunk.rows());
+    if (static_cast<size_t>(chunk.cols()) == d_ + get_n_discrete()) {
+      evaluate_pdf(chunk, pdf, scratch, num_threads, log);
+    } else {
+      evaluate_pdf(collapse_data(chunk), pdf, scratch, num_threads, log);
+    }
+    sink(pdf);
+    has_chunk = reader.get();
+    chunk.swap(next_chunk);
+  }
+}
+
+//! @brief Evaluates the copula density on a (collapsed) data set.
+//!
+//! @param u An \f$ n \times (d + k) \f$ matrix of evaluation points (see
+//!   `collapse_data()`).
+//! @param pdf A vector of size \f$ n \f$ that will contain the density.
+//! @param scratch Temporary storage used for the batches.
+//! @param num_threads The number of threads to use for computations.
+//! @param log Whether the logarithm of the density should be computed.
+inline void
+Vinecop::evaluate_pdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                      Eigen::VectorXd& pdf,
+                      EvaluationScratchPool& scratch,
+                      const size_t num_threads,
+                      const bool log) const
+{
+  size_t trunc_lvl = plan_.get_trunc_lvl();
+  const auto& input_cols = plan_.get_input_cols();
+  const auto& input_sub_cols = plan_.get_input_sub_cols();
+  const auto& steps = plan_.get_steps();
+
+  // initial value must be 1.0 for multiplication (0.0 for summation)
+  pdf.setConstant(log ? 0.0 : 1.0);
 
   auto do_batch = [&](const tools_batch::Batch& b) {
     // temporary storage objects (all data must be in (0, 1))
-    Eigen::MatrixXd hfunc1, hfunc2, u_e, hfunc1_sub, hfunc2_sub, u_e_sub;
-    hfunc1 = Eigen::MatrixXd::Zero(b.size, d_);
-    hfunc2 = Eigen::MatrixXd::Zero(b.size, d_);
-    if (get_n_discrete() > 0) {
-      hfunc1_sub = hfunc1;
-      hfunc2_sub = hfunc2;
+    auto storage = scratch.acquire();
+    storage->reserve(b.size, d_, plan_.has_discrete());
+    auto hfunc1 = storage->hfunc1.topRows(b.size);
+    auto hfunc2 = storage->hfunc2.topRows(b.size);
+    auto u_e = storage->u_e.topRows(b.size);
+    // storage for discrete variables is only allocated if needed; otherwise,
+    // the blocks below refer to (unused) continuous storage
+    bool has_disc = plan_.has_discrete();
+    auto hfunc1_sub =
+      (has_disc ? storage->hfunc1_sub : storage->hfunc1).topRows(b.size);
+    auto hfunc2_sub =
+      (has_disc ? storage->hfunc2_sub : storage->hfunc2).topRows(b.size);
+    auto u_e_disc =
+      (has_disc ? storage->u_e_disc : storage->u_e).topRows(b.size);
+    auto pdf_e = storage->values_e.head(b.size);
+    // independence copulas are short-circuited, unless missing values have
+    // to be propagated through their h-functions
+    bool short_circuit = !u.middleRows(b.begin, b.size).hasNaN();
+    hfunc1.setZero();
+    hfunc2.setZero();
+    if (has_disc) {
+      hfunc1_sub.setZero();
+      hfunc2_sub.setZero();
     }
 
     // fill first row of hfunc2 matrix with evaluation points;
     // points have to be reordered to correspond to natural order
     for (size_t j = 0; j < d_; ++j) {
-      hfunc2.col(j) = u.block(b.begin, order[j] - 1, b.size, 1);
-      if (var_types_[order[j] - 1] == "d") {
-        hfunc2_sub.col(j) =
-          u.block(b.begin, d_ + disc_cols[order[j] - 1], b.size, 1);
+      hfunc2.col(j) = u.block(b.begin, input_cols[j], b.size, 1);
+      if (input_sub_cols[j] >= 0) {
+        hfunc2_sub.col(j) = u.block(b.begin, input_sub_cols[j], b.size, 1);
       }
     }
 
-    for (size_t tree = 0; tree < trunc_lvl; ++tree) {
-      tools_interface::check_user_interrupt(
-        static_cast<double>(u.rows()) * static_cast<double>(d_) > 1e5);
-      for (size_t edge = 0; edge < d_ - tree - 1; ++edge) {
-        tools_interface::check_user_interrupt(edge % 100 == 0);
-        // extract evaluation point from hfunction matrices (have been
-        // computed in previous tree level)
-        Bicop* edge_copula = &pair_copulas_[tree][edge];
-        auto var_types = edge_copula->get_var_types();
-        size_t m = rvine_structure_.min_array(tree, edge);
-
-        u_e = Eigen::MatrixXd(b.size, 2);
-        u_e.col(0) = hfunc2.col(edge);
-        if (m == rvine_structure_.struct_array(tree, edge, true)) {
-          u_e.col(1) = hfunc2.col(m - 1);
-        } else {
-          u_e.col(1) = hfunc1.col(m - 1);
-        }
+    // Gaussian vines are evaluated as multivariate normal
+    if (short_circuit && !has_disc && (gaussian_plan_.get_dim() > 0)) {
+      if (log) {
+        pdf.segment(b.begin, b.size) = gaussian_plan_.logpdf(hfunc2);
+      } else {
+        pdf.segment(b.begin, b.size) = gaussian_plan_.pdf(hfunc2);
+      }
+      scratch.release(std::move(storage));
+      return;
+    }
 
-        if ((var_types[0] == "d") | (var_types[1] == "d")) {
-          u_e.conservativeResize(b.size, 4);
-          u_e.col(2) = hfunc2_sub.col(edge);
-          if (m == rvine_structure_.struct_array(tree, edge, true)) {
-            u_e.col(3) = hfunc2_sub.col(m - 1);
+    for (const auto& step : steps) {
+      tools_interface::check_user_interrupt(step.edge % 100 == 0);
+      const Bicop& edge_copula = pair_copulas_[step.tree][step.edge];
+      bool needs_hfunc1 = short_circuit ? step.live_hfunc1 : step.needs_hfunc1;
+      bool needs_hfunc2 = short_circuit ? step.live_hfunc2 : step.needs_hfunc2;
+      if (short_circuit && step.indep) {
+        // the density is one (log-density zero), hfunc2 returns the first
+        // argument (which is already in place), and hfunc1 returns the
+        // second argument
+        if (needs_hfunc1) {
+          if (step.arg_hfunc2) {
+            hfunc1.col(step.edge) = hfunc2.col(step.arg_col);
           } else {
-            u_e.col(3) = hfunc1_sub.col(m - 1);
+            hfunc1.col(step.edge) = hfunc1.col(step.arg_col);
           }
-        }
-
-        pdf.segment(b.begin, b.size) =
-          pdf.segment(b.begin, b.size).cwiseProduct(edge_copula->pdf(u_e));
-
-        // h-functions are only evaluated if needed in next step
-        if (rvine_structure_.needed_hfunc1(tree, edge)) {
-          hfunc1.col(edge) = edge_copula->hfunc1(u_e);
-          if (var_types[1] == "d") {
-            u_e_sub = u_e;
-            u_e_sub.col(1) = u_e.col(3);
-            hfunc1_sub.col(edge) = edge_copula->hfunc1(u_e_sub);
+          if (step.disc2) {
+            if (step.arg_hfunc2) {
+              hfunc1_sub.col(step.edge) = hfunc2_sub.col(step.arg_col);
+            } else {
+              hfunc1_sub.col(step.edge) = hfunc1_sub.col(step.arg_col);
+            }
           }
         }
-        if (rvine_structure_.needed_hfunc2(tree, edge)) {
-          hfunc2.col(edge) = edge_copula->hfunc2(u_e);
-          if (var_types[0] == "d") {
-            u_e_sub = u_e;
-            u_e_sub.col(0) = u_e.col(2);
-            hfunc2_sub.col(edge) = edge_copula->hfunc2(u_e_sub);
-          }
+        continue;
+      }
+
+      // extract evaluation point from hfunction matrices (have been
+      // computed in previous tree level)
+      bool is_disc = step.disc1 | step.disc2;
+      auto& u_edge = is_disc ? u_e_disc : u_e;
+      u_edge.col(0) = hfunc2.col(step.edge);
+      if (step.arg_hfunc2) {
+        u_edge.col(1) = hfunc2.col(step.arg_col);
+      } else {
+        u_edge.col(1) = hfunc1.col(step.arg_col);
+      }
+      if (is_disc) {
+        u_edge.col(2) = hfunc2_sub.col(step.edge);
+        if (step.arg_hfunc2) {
+          u_edge.col(3) = hfunc2_sub.col(step.arg_col);
+        } else {
+          u_edge.col(3) = hfunc1_sub.col(step.arg_col);
         }
       }
+
+      // the density and the h-functions needed in the next tree are
+      // evaluated together
+      edge_copula.evaluate(u_edge,
+                           pdf_e,
+                           hfunc1.col(step.edge),
+                           hfunc2.col(step.edge),
+                           true,
+                           needs_hfunc1,
+                           needs_hfunc2,
+                           log);
+      if (log) {
+        pdf.segment(b.begin, b.size) += pdf_e;
+      } else {
+        pdf.segment(b.begin, b.size).array() *= pdf_e.array();
+      }
+
+      // left-sided limits of the h-functions for discrete variables
+      if (needs_hfunc1 && step.disc2) {
+        u_edge.col(1).swap(u_edge.col(3));
+        edge_copula.hfunc1(u_edge, hfunc1_sub.col(step.edge));
+        u_edge.col(1).swap(u_edge.col(3));
+      }
+      if (needs_hfunc2 && step.disc1) {
+        u_edge.col(0).swap(u_edge.col(2));
+        edge_copula.hfunc2(u_edge, hfunc2_sub.col(step.edge));
+        u_edge.col(0).swap(u_edge.col(2));
+      }
     }
+    scratch.release(std::move(storage));
   };
 
   if (trunc_lvl > 0) {
@@ -835,14 +1003,18 @@ Vinecop::pdf(Eigen::MatrixXd u, const size_t num_threads) const
     pool.map(do_batch, tools_batch::create_batches(u.rows(), num_threads));
     pool.join();
   }
-
-  return pdf;
 }
 
 //! @brief Evaluates the copula distribution.
 //!
 //! Because no closed-form expression is available, the distribution is
-//! estimated numerically using Monte Carlo integration.
+//! estimated numerically using Monte Carlo integration: it is the fraction of
+//! `N` quasi-random samples from the model that are dominated by the
+//! evaluation point. The samples are indexed in a kd-tree (see
+//! `DominanceIndex`), such that most of them don't have to be visited.
+//!
+//! If `seeds` are provided, the sample is cached and reused by subsequent
+//! calls with the same `N` and `seeds` (until the model is modified).
 //!
 //! @param u An \f$ n \times (d + k) \f$ or \f$ n \times 2d \f$ matrix of
 //!   evaluation points, where \f$ k \f$ is the number of discrete variables
@@ -850,39 +1022,153 @@ Vinecop::pdf(Eigen::MatrixXd u, const size_t num_threads) const
 //! @param N Integer for the number of quasi-random numbers to draw
 //! to evaluate the distribution (default: 1e4).
 //! @param num_threads The number of threads to use for computations; if greater
-//!   than 1, the function will generate `n` samples concurrently in
-//!   `num_threads` batches.
+//!   than 1, the function will generate `N` samples and evaluate the
+//!   distribution concurrently in `num_threads` batches.
 //! @param seeds Seeds to scramble the quasi-random numbers; if empty (default),
 //!   the random number quasi-generator is seeded randomly.
 inline Eigen::VectorXd
-Vinecop::cdf(const Eigen::MatrixXd& u,
+Vinecop::cdf(const Eigen::Ref<const Eigen::MatrixXd>& u,
              const size_t N,
              const size_t num_threads,
              std::vector<int> seeds) const
 {
-  if (d_ > 21201) {
-    std::stringstream message;
-    message << "cumulative distribution available for models of "
-            << "dimension 21201 or less. This model's dimension: " << d_
-            << std::endl;
-    throw std::runtime_error(message.str().c_str());
-  }
+  check_cdf_dim();
   check_data(u);
 
-  // Simulate N quasi-random numbers from the vine model
-  auto u_sim = simulate(N, true, num_threads, seeds);
+  // simulate N quasi-random numbers from the vine model (if necessary)
+  auto sample = std::atomic_load(&cdf_sample_);
+  if (seeds.empty() || !sample || (sample->N != N) ||
+      (sample->seeds != seeds)) {
+    DominanceIndex index(simulate(N, true, num_threads, seeds));
+    sample = std::make_shared<const CdfSample>(CdfSample{ N, seeds, index });
+    if (!seeds.empty()) {
+      std::atomic_store(&cdf_sample_, sample);
+    }
+  }
+
+  Eigen::VectorXd vine_distribution(u.rows());
+  auto do_batch = [&](const tools_batch::Batch& b) {
+    tools_interface::check_user_interrupt();
+    for (size_t i = b.begin; i < b.begin + b.size; i++) {
+      auto q = u.row(i).head(d_);
+      if (q.hasNaN()) {
+        vine_distribution(i) = std::numeric_limits<double>::quiet_NaN();
+      } else {
+        vine_distribution(i) = static_cast<double>(sample->index.count(q));
+      }
+    }
+  };
+  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
+  pool.map(do_batch, tools_batch::create_batches(u.rows(), num_threads));
+  pool.join();
+
+  return vine_distribution / static_cast<double>(N);
+}
+
+//! @brief Evaluates the copula distribution up to a given precision.
+//!
+//! The distribution is estimated as in `cdf()`, but from 8 independently
+//! randomized quasi-random samples. Their spread gives a standard error for
+//! each evaluation point. The samples are doubled in size until the standard
+//! error of each point is at most \f$ \max(\epsilon_{abs}, \epsilon_{rel}
+//! \cdot F) \f$ (where \f$ F \f$ is the estimate) or the total sample size
+//! would exceed `N_max`. Only points whose estimates have not yet converged
+//! are evaluated on the new samples.
+//!
+//! @param u An \f$ n \times (d + k) \f$ or \f$ n \times 2d \f$ matrix of
+//!   evaluation points, where \f$ k \f$ is the number of discrete variables
+//!   (see `select()`).
+//! @param abs_tol Absolute tolerance for the standard error.
+//! @param rel_tol Relative tolerance for the standard error.
+//! @param N_max Maximal number of quasi-random numbers to draw (in total).
+//! @param num_threads The number of threads to use for computations.
+//! @param seeds Seeds to scramble the quasi-random numbers; if empty (default),
+//!   the random number quasi-generator is seeded randomly.
+//! @return An \f$ n \times 2 \f$ matrix containing the estimated
+//!   distribution in the first and its standard error in the second column.
+inline Eigen::MatrixXd
+Vinecop::cdf_adaptive(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                      const double abs_tol,
+                      const double rel_tol,
+                      const size_t N_max,
+                      const size_t num_threads,
+                      std::vector<int> seeds) const
+{
+  check_cdf_dim();
+  check_data(u);
+  if ((abs_tol < 0.0) || (rel_tol < 0.0)) {
+    throw std::runtime_error("tolerances must be non-negative.");
+  }
+  if (seeds.empty()) {
+    std::random_device rd{};
+    seeds = std::vector<int>(5);
+    std::generate(
+      seeds.begin(), seeds.end(), [&]() { return static_cast<int>(rd()); });
+  }
 
+  const size_t num_reps = 8;
   size_t n = u.rows();
-  Eigen::VectorXd vine_distribution(n);
-  Eigen::ArrayXXd x(N, 1);
-  Eigen::RowVectorXd temp(d_);
+  Eigen::MatrixXd cdf(n, 2);
+  Eigen::MatrixXd counts = Eigen::MatrixXd::Zero(n, num_reps);
+  std::vector<size_t> active;
   for (size_t i = 0; i < n; i++) {
-    tools_interface::check_user_interrupt(i % 1000 == 0);
-    temp = u.block(i, 0, 1, d_);
-    x = (u_sim.rowwise() - temp).rowwise().maxCoeff().array();
-    vine_distribution(i) = static_cast<double>((x <= 0.0).count());
+    if (u.row(i).head(d_).hasNaN()) {
+      cdf.row(i).setConstant(std::numeric_limits<double>::quiet_NaN());
+    } else {
+      active.push_back(i);
+    }
   }
-  return vine_distribution / static_cast<double>(N);
+
+  tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
+  size_t N_old = 0;
+  size_t N_new = std::max(std::min(N_max / num_reps, static_cast<size_t>(256)),
+                          static_cast<size_t>(1));
+  while (!active.empty()) {
+    for (size_t r = 0; r < num_reps; r++) {
+      // the first points of a quasi-random sequence don't depend on the
+      // sample size, so only the new points have to be simulated
+      auto rep_seeds = seeds;
+      rep_seeds.push_back(static_cast<int>(r));
+      Eigen::MatrixXd u_sim =
+        tools_stats::simulate_uniform(N_new, d_, true, rep_seeds, num_threads)
+          .bottomRows(N_new - N_old);
+      DominanceIndex index(simulate_from_uniform(u_sim, num_threads));
+      auto do_batch = [&](const tools_batch::Batch& b) {
+        tools_interface::check_user_interrupt();
+        for (size_t k = b.begin; k < b.begin + b.size; k++) {
+          counts(active[k], r) +=
+            static_cast<double>(index.count(u.row(active[k]).head(d_)));
+        }
+      };
+      auto batches = tools_batch::create_batches(active.size(), num_threads);
+      pool.map(do_batch, batches);
+      pool.wait();
+    }
+
+    // points whose standard error is small enough are done
+    std::vector<size_t> not_converged;
+    for (size_t i : active) {
+      Eigen::ArrayXd p = counts.row(i).array() / static_cast<double>(N_new);
+      cdf(i, 0) = p.mean();
+      cdf(i, 1) = std::sqrt((p - cdf(i, 0)).square().sum() /
+                            static_cast<double>(num_reps * (num_reps - 1)));
+      // estimates of each sample are multiples of 1 / N_new
+      double tol = std::max(abs_tol, rel_tol * cdf(i, 0));
+      if ((cdf(i, 1) > tol) || (1.0 / static_cast<double>(N_new) > tol)) {
+        not_converged.push_back(i);
+      }
+    }
+    active.swap(not_converged);
+
+    N_old = N_new;
+    N_new *= 2;
+    if (N_new * num_reps > N_max) {
+      break;
+    }
+  }
+  pool.join();
+
+  return cdf;
 }
 
 //! @brief Simulates from a vine copula model, see `inverse_rosenblatt()`.
@@ -893,7 +1179,7 @@ Vinecop::cdf(const Eigen::MatrixXd& u,
 //! @param qrng Set to true for quasi-random numbers.
 //! @param num_threads The number of threads to use for computations; if greater
 //!   than 1, the function will generate `n` samples concurrently in
-//!   `num_threads` batches.
+//!   `num_threads` batches. The samples do not depend on `num_threads`.
 //! @param seeds Seeds of the random number generator; if empty (default),
 //!   the random number generator is seeded randomly.
 //! @return An \f$ n \times d \f$ matrix of samples from the copula model.
@@ -903,13 +1189,32 @@ Vinecop::simulate(const size_t n,
                   const size_t num_threads,
                   const std::vector<int>& seeds) const
 {
-  auto u = tools_stats::simulate_uniform(n, d_, qrng, seeds);
-  // inverse_rosenblatt() only works for continous models
-  auto actual_types = var_types_;
-  set_continuous_var_types();
-  u = inverse_rosenblatt(u, num_threads);
-  set_var_types_internal(actual_types);
-  return u;
+  auto u = tools_stats::simulate_uniform(n, d_, qrng, seeds, num_threads);
+  return simulate_from_uniform(u, num_threads);
+}
+
+//! @brief Transforms independent uniforms into samples from the model.
+//!
+//! In contrast to `inverse_rosenblatt()`, the function also works for
+//! models with discrete variables (the samples are always continuous).
+//! @param u An \f$ n \times d \f$ matrix of independent uniforms.
+//! @param num_threads The number of threads to use for computations.
+inline Eigen::MatrixXd
+Vinecop::simulate_from_uniform(const Eigen::MatrixXd& u,
+                               const size_t num_threads) const
+{
+  if (get_n_discrete() == 0) {
+    return evaluate_inverse_rosenblatt(u, pair_copulas_, num_threads);
+  }
+  // samples are continuous, so the pair-copulas are evaluated as if all
+  // variables were continuous (on copies, the model is not modified)
+  auto pair_copulas = pair_copulas_;
+  for (auto& tree : pair_copulas) {
+    for (auto& pc : tree) {
+      pc = pc.as_continuous();
+    }
+  }
+  return evaluate_inverse_rosenblatt(u, pair_copulas, num_threads);
 }
 
 //! @brief Evaluates the log-likelihood.
@@ -925,15 +1230,38 @@ Vinecop::simulate(const size_t n,
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline double
-Vinecop::loglik(const Eigen::MatrixXd& u, const size_t num_threads) const
+Vinecop::loglik(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                const size_t num_threads) const
 {
   if (u.rows() < 1) {
     return this->get_loglik();
   } else {
-    return pdf(u, num_threads).array().log().sum();
+    return logpdf(u, num_threads).sum();
   }
 }
 
+//! @brief Evaluates the log-likelihood on data that is read in chunks.
+//!
+//! See `pdf_chunked()` for details.
+//!
+//! @param source A function that fills its argument with the next chunk of
+//!   evaluation points (see `pdf()` for the format) and returns `false` when
+//!   there is no more data.
+//! @param num_threads The number of threads to use for evaluating each
+//!   chunk.
+inline double
+Vinecop::loglik_chunked(const std::function<bool(Eigen::MatrixXd&)>& source,
+                        const size_t num_threads) const
+{
+  double ll = 0.0;
+  evaluate_pdf_chunked(
+    source,
+    [&ll](const Eigen::VectorXd& logpdf) { ll += logpdf.sum(); },
+    num_threads,
+    true);
+  return ll;
+}
+
 //! @brief Evaluates the Akaike information criterion (AIC).
 //!
 //! The AIC is defined as
@@ -950,7 +1278,8 @@ Vinecop::loglik(const Eigen::MatrixXd& u, const size_t num_threads) const
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline double
-Vinecop::aic(const Eigen::MatrixXd& u, const size_t num_threads) const
+Vinecop::aic(const Eigen::Ref<const Eigen::MatrixXd>& u,
+             const size_t num_threads) const
 {
   return -2 * this->loglik(u, num_threads) + 2 * get_npars();
 }
@@ -971,7 +1300,8 @@ Vinecop::aic(const Eigen::MatrixXd& u, const size_t num_threads) const
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline double
-Vinecop::bic(const Eigen::MatrixXd& u, const size_t num_threads) const
+Vinecop::bic(const Eigen::Ref<const Eigen::MatrixXd>& u,
+             const size_t num_threads) const
 {
   return -2 * this->loglik(u, num_threads) +
          get_npars() * log(static_cast<double>(u.rows()));
@@ -1000,7 +1330,7 @@ Vinecop::bic(const Eigen::MatrixXd& u, const size_t num_threads) const
 //!   of `u`.
 // clang-format on
 inline double
-Vinecop::mbicv(const Eigen::MatrixXd& u,
+Vinecop::mbicv(const Eigen::Ref<const Eigen::MatrixXd>& u,
                const double psi0,
                const size_t num_threads) const
 {
@@ -1035,51 +1365,71 @@ Vinecop::get_npars() const
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline Eigen::MatrixXd
-Vinecop::rosenblatt(const Eigen::MatrixXd& u, const size_t num_threads) const
+Vinecop::rosenblatt(const Eigen::Ref<const Eigen::MatrixXd>& u,
+                    const size_t num_threads) const
 {
   if (get_n_discrete() > 0) {
     throw std::runtime_error("rosenblatt() only works for continuous models.");
   }
   check_data(u);
-  size_t d = u.cols();
   size_t n = u.rows();
 
-  // info about the vine structure
-  size_t trunc_lvl = rvine_structure_.get_trunc_lvl();
-  auto order = rvine_structure_.get_order();
-  auto inverse_order = tools_stl::invert_permutation(order);
+  size_t trunc_lvl = plan_.get_trunc_lvl();
+  const auto& input_cols = plan_.get_input_cols();
+  const auto& output_cols = plan_.get_output_cols();
+  const auto& steps = plan_.get_steps();
 
   // fill first row of hfunc2 matrix with evaluation points;
   // points have to be reordered to correspond to natural order
-  Eigen::MatrixXd hfunc1(n, d);
-  Eigen::MatrixXd hfunc2(n, d);
-  for (size_t j = 0; j < d; ++j)
-    hfunc2.col(j) = u.col(order[j] - 1);
+  Eigen::MatrixXd hfunc1(n, d_);
+  Eigen::MatrixXd hfunc2(n, d_);
+  for (size_t j = 0; j < d_; ++j)
+    hfunc2.col(j) = u.col(input_cols[j]);
 
   auto do_batch = [&](const tools_batch::Batch& b) {
     Eigen::MatrixXd u_e(b.size, 2);
-    for (size_t tree = 0; tree < trunc_lvl; ++tree) {
-      tools_interface::check_user_interrupt(
-        static_cast<double>(n) * static_cast<double>(d) > 1e5);
-      for (size_t edge = 0; edge < d - tree - 1; ++edge) {
-        tools_interface::check_user_interrupt(edge % 100 == 0);
-        // extract evaluation point from hfunction matrices (have been
-        // computed in previous tree level)
-        size_t m = rvine_structure_.min_array(tree, edge);
-        u_e.col(0) = hfunc2.block(b.begin, edge, b.size, 1);
-        if (m == rvine_structure_.struct_array(tree, edge, true)) {
-          u_e.col(1) = hfunc2.block(b.begin, m - 1, b.size, 1);
-        } else {
-          u_e.col(1) = hfunc1.block(b.begin, m - 1, b.size, 1);
+    Eigen::VectorXd no_pdf;
+    // independence copulas are short-circuited, unless missing values have
+    // to be propagated through their h-functions
+    bool short_circuit = !u.middleRows(b.begin, b.size).hasNaN();
+    if (short_circuit && (gaussian_plan_.get_dim() > 0)) {
+      // Gaussian vines are evaluated as multivariate normal
+      hfunc2.middleRows(b.begin, b.size) =
+        gaussian_plan_.rosenblatt(hfunc2.middleRows(b.begin, b.size));
+      return;
+    }
+    for (const auto& step : steps) {
+      tools_interface::check_user_interrupt(step.edge % 100 == 0);
+      bool needs_hfunc1 = short_circuit ? step.live_hfunc1 : step.needs_hfunc1;
+      if (short_circuit && step.indep) {
+        // hfunc2 returns the first argument (which is already in place),
+        // hfunc1 returns the second argument
+        if (needs_hfunc1) {
+          auto& arg = step.arg_hfunc2 ? hfunc2 : hfunc1;
+          hfunc1.block(b.begin, step.edge, b.size, 1) =
+            arg.block(b.begin, step.arg_col, b.size, 1);
         }
+        continue;
+      }
 
-        // h-functions are only evaluated if needed in next step
-        Bicop edge_copula = pair_copulas_[tree][edge].as_continuous();
-        if (rvine_structure_.needed_hfunc1(tree, edge)) {
-          hfunc1.block(b.begin, edge, b.size, 1) = edge_copula.hfunc1(u_e);
-        }
-        hfunc2.block(b.begin, edge, b.size, 1) = edge_copula.hfunc2(u_e);
+      // extract evaluation point from hfunction matrices (have been
+      // computed in previous tree level)
+      u_e.col(0) = hfunc2.block(b.begin, step.edge, b.size, 1);
+      if (step.arg_hfunc2) {
+        u_e.col(1) = hfunc2.block(b.begin, step.arg_col, b.size, 1);
+      } else {
+        u_e.col(1) = hfunc1.block(b.begin, step.arg_col, b.size, 1);
       }
+
+      // h-functions are only evaluated if needed in next step
+      const Bicop& edge_copula = pair_copulas_[step.tree][step.edge];
+      edge_copula.evaluate(u_e,
+                           no_pdf,
+                           hfunc1.col(step.edge).segment(b.begin, b.size),
+                           hfunc2.col(step.edge).segment(b.begin, b.size),
+                           false,
+                           needs_hfunc1,
+                           true);
     }
   };
 
@@ -1090,9 +1440,9 @@ Vinecop::rosenblatt(const Eigen::MatrixXd& u, const size_t num_threads) const
   }
 
   // go back to original order
-  auto U_vine = u;
-  for (size_t j = 0; j < d; j++) {
-    U_vine.col(j) = hfunc2.col(inverse_order[j]);
+  Eigen::MatrixXd U_vine(n, d_);
+  for (size_t j = 0; j < d_; j++) {
+    U_vine.col(j) = hfunc2.col(output_cols[j]);
   }
 
   return U_vine.array().min(1 - 1e-10).max(1e-10);
@@ -1117,7 +1467,7 @@ Vinecop::rosenblatt(const Eigen::MatrixXd& u, const size_t num_threads) const
 //!   than 1, the function will be applied concurrently to `num_threads` batches
 //!   of `u`.
 inline Eigen::MatrixXd
-Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
+Vinecop::inverse_rosenblatt(const Eigen::Ref<const Eigen::MatrixXd>& u,
                             const size_t num_threads) const
 {
   if (get_n_discrete() > 0) {
@@ -1125,6 +1475,21 @@ Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
       "inverse_rosenblatt() only works for continuous models.");
   }
   check_data(u);
+  return evaluate_inverse_rosenblatt(u, pair_copulas_, num_threads);
+}
+
+//! @brief Evaluates the inverse Rosenblatt transform with given
+//! pair-copulas (see `inverse_rosenblatt()`).
+//! @param u An \f$ n \times d \f$ matrix of evaluation points.
+//! @param pair_copulas The pair-copulas (continuous, in the layout of
+//!   `pair_copulas_`).
+//! @param num_threads The number of threads to use for computations.
+inline Eigen::MatrixXd
+Vinecop::evaluate_inverse_rosenblatt(
+  const Eigen::Ref<const Eigen::MatrixXd>& u,
+  const std::vector<std::vector<Bicop>>& pair_copulas,
+  const size_t num_threads) const
+{
   size_t n = u.rows();
   if (n < 1) {
     throw std::runtime_error("n must be at least one");
@@ -1139,28 +1504,45 @@ Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
   if ((n > 1) & (bytes_required > static_cast<size_t>(1e9))) {
     size_t n_half = n / 2;
     size_t n_left = n - n_half;
-    U_vine.block(0, 0, n_half, d) =
-      inverse_rosenblatt(u.block(0, 0, n_half, d));
-    U_vine.block(n_half, 0, n_left, d) =
-      inverse_rosenblatt(u.block(n_half, 0, n_left, d));
+    U_vine.block(0, 0, n_half, d) = evaluate_inverse_rosenblatt(
+      u.block(0, 0, n_half, d), pair_copulas, num_threads);
+    U_vine.block(n_half, 0, n_left, d) = evaluate_inverse_rosenblatt(
+      u.block(n_half, 0, n_left, d), pair_copulas, num_threads);
     return U_vine;
   }
 
-  // info about the vine structure (in upper triangular matrix notation)
-  size_t trunc_lvl = rvine_structure_.get_trunc_lvl();
-  auto order = rvine_structure_.get_order();
-  auto inverse_order = tools_stl::invert_permutation(order);
+  size_t trunc_lvl = plan_.get_trunc_lvl();
+  const auto& input_cols = plan_.get_input_cols();
+  const auto& output_cols = plan_.get_output_cols();
 
   auto do_batch = [&](const tools_batch::Batch& b) {
+    // independence copulas are short-circuited, unless missing values have
+    // to be propagated through their h-functions
+    bool short_circuit = !u.middleRows(b.begin, b.size).hasNaN();
+    if (short_circuit && (gaussian_plan_.get_dim() > 0)) {
+      // Gaussian vines are evaluated as multivariate normal (the
+      // pair-copulas only differ from `pair_copulas_` in variable types)
+      Eigen::MatrixXd u_nat(b.size, d);
+      for (size_t j = 0; j < d; ++j) {
+        u_nat.col(j) = u.block(b.begin, input_cols[j], b.size, 1);
+      }
+      u_nat = gaussian_plan_.inverse_rosenblatt(u_nat);
+      for (size_t j = 0; j < d; j++) {
+        U_vine.block(b.begin, j, b.size, 1) = u_nat.col(output_cols[j]);
+      }
+      return;
+    }
+
     // temporary storage objects for (inverse) h-functions
     TriangularArray<Eigen::VectorXd> hinv2(d + 1, trunc_lvl + 1);
     TriangularArray<Eigen::VectorXd> hfunc1(d + 1, trunc_lvl + 1);
+    Eigen::MatrixXd U_e(b.size, 2);
 
     // initialize with independent uniforms (corresponding to natural
     // order)
     for (size_t j = 0; j < d; ++j) {
       hinv2(std::min(trunc_lvl, d - j - 1), j) =
-        u.block(b.begin, order[j] - 1, b.size, 1);
+        u.block(b.begin, input_cols[j], b.size, 1);
     }
     hfunc1(0, d - 1) = hinv2(0, d - 1);
 
@@ -1170,36 +1552,49 @@ Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
         static_cast<double>(n) * static_cast<double>(d) > 1e5);
       size_t tree_start = std::min(trunc_lvl - 1, d - var - 2);
       for (ptrdiff_t tree = tree_start; tree >= 0; --tree) {
-        Bicop edge_copula = pair_copulas_[tree][var].as_continuous();
+        const auto& step = plan_.get_step(tree, var);
+        const Bicop& edge_copula = pair_copulas[tree][var];
+        bool needs_hfunc1 = (var < static_cast<ptrdiff_t>(d_) - 1) &&
+                            (short_circuit ? step.live_hfunc1
+                                           : step.needs_hfunc1);
+        if (short_circuit && step.indep) {
+          // hinv2 returns the first argument, hfunc1 the second argument
+          hinv2(tree, var) = hinv2(tree + 1, var);
+          if (needs_hfunc1) {
+            if (step.arg_hfunc2) {
+              hfunc1(tree + 1, var) = hinv2(tree, step.arg_col);
+            } else {
+              hfunc1(tree + 1, var) = hfunc1(tree, step.arg_col);
+            }
+          }
+          continue;
+        }
 
         // extract data for conditional pair
-        Eigen::MatrixXd U_e(b.size, 2);
-        size_t m = rvine_structure_.min_array(tree, var);
         U_e.col(0) = hinv2(tree + 1, var);
-        if (m == rvine_structure_.struct_array(tree, var, true)) {
-          U_e.col(1) = hinv2(tree, m - 1);
+        if (step.arg_hfunc2) {
+          U_e.col(1) = hinv2(tree, step.arg_col);
         } else {
-          U_e.col(1) = hfunc1(tree, m - 1);
+          U_e.col(1) = hfunc1(tree, step.arg_col);
         }
 
         // inverse Rosenblatt transform simulates data for conditional pair
         hinv2(tree, var) = edge_copula.hinv2(U_e);
 
         // if required at later stage, also calculate hfunc2
-        if (var < static_cast<ptrdiff_t>(d_) - 1) {
-          if (rvine_structure_.needed_hfunc1(tree, var)) {
-            U_e.col(0) = hinv2(tree, var);
-            hfunc1(tree + 1, var) = edge_copula.hfunc1(U_e);
-          }
+        if (needs_hfunc1) {
+          U_e.col(0) = hinv2(tree, var);
+          hfunc1(tree + 1, var) = edge_copula.hfunc1(U_e);
         }
       }
     }
     // go back to original order
     for (size_t j = 0; j < d; j++) {
-      U_vine.block(b.begin, j, b.size, 1) = hinv2(0, inverse_order[j]);
+      U_vine.block(b.begin, j, b.size, 1) = hinv2(0, output_cols[j]);
     }
   };
 
+
   if (trunc_lvl > 0) {
     tools_thread::ThreadPool pool((num_threads == 1) ? 0 : num_threads);
     pool.map(do_batch, tools_batch::create_batches(n, num_threads));
@@ -1211,7 +1606,7 @@ Vinecop::inverse_rosenblatt(const Eigen::MatrixXd& u,
 
 //! Checks if dimension d of the data matches the dimension of the vine.
 inline void
-Vinecop::check_data_dim(const Eigen::MatrixXd& data) const
+Vinecop::check_data_dim(const Eigen::Ref<const Eigen::MatrixXd>& data) const
 {
   size_t d_data = data.cols();
   auto n_disc = get_n_discrete();
@@ -1234,12 +1629,26 @@ Vinecop::check_data_dim(const Eigen::MatrixXd& data) const
 
 //! Checks if dimension d of the data matches the dimension of the vine.
 inline void
-Vinecop::check_data(const Eigen::MatrixXd& data) const
+Vinecop::check_data(const Eigen::Ref<const Eigen::MatrixXd>& data) const
 {
   check_data_dim(data);
   tools_eigen::check_if_in_unit_cube(data);
 }
 
+//! @brief Checks if the dimension is small enough for `cdf()`, which
+//! requires quasi-random numbers.
+inline void
+Vinecop::check_cdf_dim() const
+{
+  if (d_ > 21201) {
+    std::stringstream message;
+    message << "cumulative distribution available for models of "
+            << "dimension 21201 or less. This model's dimension: " << d_
+            << std::endl;
+    throw std::runtime_error(message.str().c_str());
+  }
+}
+
 //! Checks if pair copulas are compatible with the R-vine structure.
 inline void
 Vinecop::check_pair_copulas_rvine_structure(
@@ -1273,6 +1682,7 @@ Vinecop::finalize_fit(const tools_select::VinecopSelector& selector)
   loglik_ = selector.get_loglik();
   nobs_ = selector.get_nobs();
   pair_copulas_ = selector.get_pair_copulas();
+  compile();
 }
 
 //! Checks if weights are compatible with the data.
@@ -1334,34 +1744,62 @@ Vinecop::truncate(size_t trunc_lvl)
   if (trunc_lvl < this->get_trunc_lvl()) {
     rvine_structure_.truncate(trunc_lvl);
     pair_copulas_.resize(trunc_lvl);
+    compile();
   }
 }
 
 //! @brief Sets all variable types to continuous.
-//! The function can be const, because var_types_ is mutable.
 inline void
-Vinecop::set_continuous_var_types() const
+Vinecop::set_continuous_var_types()
+{
+  set_var_types_internal(std::vector<VarType>(d_, VarType::continuous));
+}
+
+//! @brief Compiles the evaluation plan (see `EvaluationPlan`), and the
+//! Gaussian evaluation plan if all pair-copulas are Gaussian or independent
+//! (see `GaussianPlan`).
+//!
+//! Must be called whenever the model changes; also discards the sample
+//! cached by `cdf()`.
+inline void
+Vinecop::compile()
 {
-  var_types_ = std::vector<std::string>(d_);
-  for (auto& t : var_types_)
-    t = "c";
-  set_var_types_internal(var_types_);
+  std::vector<std::vector<bool>> indep(pair_copulas_.size());
+  std::vector<std::vector<double>> rho(pair_copulas_.size());
+  bool has_gaussian = false;
+  bool all_gaussian = true;
+  for (size_t t = 0; t < pair_copulas_.size(); ++t) {
+    for (const auto& pc : pair_copulas_[t]) {
+      indep[t].push_back(pc.get_family() == BicopFamily::indep);
+      if (pc.get_family() == BicopFamily::gaussian) {
+        rho[t].push_back(pc.get_parameters()(0));
+        has_gaussian = true;
+      } else {
+        rho[t].push_back(0.0);
+        all_gaussian = all_gaussian && indep[t].back();
+      }
+    }
+  }
+  plan_ = EvaluationPlan(rvine_structure_, var_types_, indep);
+  if (has_gaussian && all_gaussian) {
+    gaussian_plan_ = GaussianPlan(plan_, rho);
+  } else {
+    gaussian_plan_ = GaussianPlan();
+  }
+  std::atomic_store(&cdf_sample_, std::shared_ptr<const CdfSample>());
 }
 
 //! @brief Returns the number of discrete variables.
 inline int
 Vinecop::get_n_discrete() const
 {
-  int n_discrete = 0;
-  for (auto t : var_types_) {
-    n_discrete += (t == "d");
-  }
-  return n_discrete;
+  return static_cast<int>(
+    std::count(var_types_.begin(), var_types_.end(), VarType::discrete));
 }
 
 //! @brief Removes superfluous columns for continuous data.
 inline Eigen::MatrixXd
-Vinecop::collapse_data(const Eigen::MatrixXd& u) const
+Vinecop::collapse_data(const Eigen::Ref<const Eigen::MatrixXd>& u) const
 {
   if (static_cast<size_t>(u.cols()) == d_ + get_n_discrete()) {
     return u;
@@ -1370,7 +1808,7 @@ Vinecop::collapse_data(const Eigen::MatrixXd& u) const
   u_new.leftCols(d_) = u.leftCols(d_);
   size_t disc_count = 0;
   for (size_t i = 0; i < d_; ++i) {
-    if (var_types_[i] == "d") {
+    if (var_types_[i] == VarType::discrete) {
       u_new.col(d_ + disc_count++) = u.col(d_ + i);
     }
   }
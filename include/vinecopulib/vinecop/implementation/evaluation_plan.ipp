@@ -0,0 +1,206 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include <vinecopulib/misc/tools_stl.hpp>
+
+namespace vinecopulib {
+
+//! @brief Compiles an evaluation plan.
+//!
+//! @param structure The vine structure.
+//! @param var_types The types of the variables; if empty,
+//!   all variables are treated as continuous.
+//! @param indep Indicates for each tree and edge whether the pair-copula is
+//!   the independence copula; edges that are missing are treated as
+//!   non-independent.
+inline EvaluationPlan::EvaluationPlan(
+  const RVineStructure& structure,
+  const std::vector<VarType>& var_types,
+  const std::vector<std::vector<bool>>& indep)
+  : d_(structure.get_dim())
+  , trunc_lvl_(structure.get_trunc_lvl())
+{
+  auto order = structure.get_order();
+
+  // input columns (natural order) and columns of the left-sided limits in
+  // the collapsed data (see `Vinecop::collapse_data()`)
+  std::vector<bool> disc(d_, false);
+  input_cols_ = std::vector<size_t>(d_);
+  input_sub_cols_ = std::vector<ptrdiff_t>(d_, -1);
+  std::vector<ptrdiff_t> sub_cols(d_, -1);
+  size_t disc_count = 0;
+  for (size_t j = 0; j < var_types.size(); ++j) {
+    if (var_types[j] == VarType::discrete) {
+      sub_cols[j] = static_cast<ptrdiff_t>(d_ + disc_count++);
+    }
+  }
+  has_discrete_ = (disc_count > 0);
+  for (size_t j = 0; j < d_; ++j) {
+    input_cols_[j] = order[j] - 1;
+    input_sub_cols_[j] = sub_cols[order[j] - 1];
+    disc[j] = (input_sub_cols_[j] >= 0);
+  }
+  output_cols_ = tools_stl::invert_permutation(order);
+
+  // one step per edge, types of the conditional variables are propagated
+  // through the trees as in `Vinecop::set_var_types_internal()`
+  tree_offsets_ = std::vector<size_t>(trunc_lvl_);
+  steps_.reserve(trunc_lvl_ * d_);
+  for (size_t t = 0; t < trunc_lvl_; ++t) {
+    tree_offsets_[t] = steps_.size();
+    for (size_t e = 0; e < d_ - t - 1; ++e) {
+      EvaluationStep step;
+      step.tree = t;
+      step.edge = e;
+      size_t m = structure.min_array(t, e);
+      step.arg_col = m - 1;
+      step.arg_hfunc2 = (m == structure.struct_array(t, e, true));
+      step.needs_hfunc1 = structure.needed_hfunc1(t, e);
+      step.needs_hfunc2 = structure.needed_hfunc2(t, e);
+      if (t == 0) {
+        step.disc1 = disc[e];
+        step.disc2 = disc[structure.struct_array(0, e, true) - 1];
+      } else {
+        const auto& prev = steps_[tree_offsets_[t - 1] + e];
+        const auto& prev_m = steps_[tree_offsets_[t - 1] + m - 1];
+        step.disc1 = prev.disc1;
+        step.disc2 = step.arg_hfunc2 ? prev_m.disc1 : prev_m.disc2;
+      }
+      step.indep = (t < indep.size()) && (e < indep[t].size()) && indep[t][e];
+      step.live_hfunc1 = false;
+      step.live_hfunc2 = false;
+      steps_.push_back(step);
+    }
+  }
+
+  // an argument is used if the pair-copula is not independent or if the
+  // h-function returning it is needed; trees are processed backwards so that
+  // the flags of the consuming tree are final
+  for (size_t t = trunc_lvl_; t-- > 1;) {
+    for (size_t e = 0; e < d_ - t - 1; ++e) {
+      const auto& step = steps_[tree_offsets_[t] + e];
+      auto& prev = steps_[tree_offsets_[t - 1] + e];
+      auto& prev_arg = steps_[tree_offsets_[t - 1] + step.arg_col];
+      prev.live_hfunc2 = prev.live_hfunc2 || !step.indep || step.live_hfunc2;
+      if (!step.indep || step.live_hfunc1) {
+        if (step.arg_hfunc2) {
+          prev_arg.live_hfunc2 = true;
+        } else {
+          prev_arg.live_hfunc1 = true;
+        }
+      }
+    }
+  }
+}
+
+//! @brief Gets the dimension of the vine.
+inline size_t
+EvaluationPlan::get_dim() const
+{
+  return d_;
+}
+
+//! @brief Gets the truncation level of the vine.
+inline size_t
+EvaluationPlan::get_trunc_lvl() const
+{
+  return trunc_lvl_;
+}
+
+//! @brief Checks whether the model contains discrete variables.
+inline bool
+EvaluationPlan::has_discrete() const
+{
+  return has_discrete_;
+}
+
+//! @brief Gets the columns of the data corresponding to the variables in
+//! natural order.
+inline const std::vector<size_t>&
+EvaluationPlan::get_input_cols() const
+{
+  return input_cols_;
+}
+
+//! @brief Gets the columns of the (collapsed) data containing the left-sided
+//! limits of the variables in natural order; -1 for continuous variables.
+inline const std::vector<ptrdiff_t>&
+EvaluationPlan::get_input_sub_cols() const
+{
+  return input_sub_cols_;
+}
+
+//! @brief Gets the natural order positions corresponding to the columns of
+//! the data (the inverse of `get_input_cols()`).
+inline const std::vector<size_t>&
+EvaluationPlan::get_output_cols() const
+{
+  return output_cols_;
+}
+
+//! @brief Gets all steps, ordered by tree and edge.
+inline const std::vector<EvaluationStep>&
+EvaluationPlan::get_steps() const
+{
+  return steps_;
+}
+
+//! @brief Gets the step for a given tree and edge.
+//! @param tree The tree index.
+//! @param edge The edge index.
+inline const EvaluationStep&
+EvaluationPlan::get_step(size_t tree, size_t edge) const
+{
+  return steps_[tree_offsets_[tree] + edge];
+}
+
+//! @brief Makes sure that the storage has enough rows for a batch.
+//!
+//! Memory is only allocated if the current storage is too small.
+//! @param rows The number of rows in the batch.
+//! @param d The dimension of the model.
+//! @param has_discrete Whether there are discrete variables.
+inline void
+EvaluationScratch::reserve(size_t rows, size_t d, bool has_discrete)
+{
+  if (static_cast<size_t>(hfunc1.rows()) < rows ||
+      static_cast<size_t>(hfunc1.cols()) != d) {
+    hfunc1.resize(rows, d);
+    hfunc2.resize(rows, d);
+    u_e.resize(rows, 2);
+    values_e.resize(rows);
+    hfunc1_sub.resize(0, 0);
+    hfunc2_sub.resize(0, 0);
+    u_e_disc.resize(0, 0);
+  }
+  if (has_discrete && (hfunc1_sub.rows() != hfunc1.rows())) {
+    hfunc1_sub.resize(hfunc1.rows(), d);
+    hfunc2_sub.resize(hfunc1.rows(), d);
+    u_e_disc.resize(hfunc1.rows(), 4);
+  }
+}
+
+//! @brief Takes a scratch object from the pool (or creates a new one).
+inline std::unique_ptr<EvaluationScratch>
+EvaluationScratchPool::acquire()
+{
+  std::lock_guard<std::mutex> lk(m_);
+  if (free_.empty()) {
+    return std::unique_ptr<EvaluationScratch>(new EvaluationScratch);
+  }
+  auto scratch = std::move(free_.back());
+  free_.pop_back();
+  return scratch;
+}
+
+//! @brief Returns a scratch object to the pool.
+inline void
+EvaluationScratchPool::release(std::unique_ptr<EvaluationScratch>&& scratch)
+{
+  std::lock_guard<std::mutex> lk(m_);
+  free_.push_back(std::move(scratch));
+}
+}
@@ -248,6 +248,8 @@ FitControlsVinecop::get_fit_controls_bicop() const
                                   get_weights(),
                                   get_psi0(),
                                   get_preselect_families());
+  controls_bicop.set_nonparametric_binned(get_nonparametric_binned());
+  controls_bicop.set_racing(get_racing());
   return controls_bicop;
 }
 
@@ -259,6 +261,8 @@ FitControlsVinecop::set_fit_controls_bicop(FitControlsBicop controls)
   set_parametric_method(controls.get_parametric_method());
   set_selection_criterion(get_selection_criterion());
   set_preselect_families(controls.get_preselect_families());
+  set_nonparametric_binned(controls.get_nonparametric_binned());
+  set_racing(controls.get_racing());
 }
 //! @}
 
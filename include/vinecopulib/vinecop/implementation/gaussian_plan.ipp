@@ -0,0 +1,158 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#include <cmath>
+#include <vinecopulib/misc/tools_eigen.hpp>
+#include <vinecopulib/misc/tools_stats.hpp>
+
+namespace vinecopulib {
+
+//! @brief Compiles a Gaussian evaluation plan.
+//!
+//! @param plan The evaluation plan of the vine.
+//! @param rho The correlation parameters of the pair-copulas (zero for
+//!   independence copulas), indexed by tree and edge.
+inline GaussianPlan::GaussianPlan(const EvaluationPlan& plan,
+                                  const std::vector<std::vector<double>>& rho)
+  : d_(plan.get_dim())
+{
+  // column e of `hfunc1` and `hfunc2` holds the coefficients of the
+  // residuals stored in column e of the h-function matrices of
+  // `Vinecop::rosenblatt()`; all coefficients above row e are zero
+  Eigen::MatrixXd hfunc1 = Eigen::MatrixXd::Zero(d_, d_);
+  Eigen::MatrixXd hfunc2 = Eigen::MatrixXd::Identity(d_, d_);
+  Eigen::VectorXd a, b;
+  for (const auto& step : plan.get_steps()) {
+    size_t m = d_ - step.edge;
+    double r = rho[step.tree][step.edge];
+    double s = std::sqrt(1.0 - r * r);
+    a = hfunc2.col(step.edge).tail(m);
+    if (step.arg_hfunc2) {
+      b = hfunc2.col(step.arg_col).tail(m);
+    } else {
+      b = hfunc1.col(step.arg_col).tail(m);
+    }
+    hfunc1.col(step.edge).tail(m) = (b - r * a) / s;
+    hfunc2.col(step.edge).tail(m) = (a - r * b) / s;
+  }
+  log_det_ = -2.0 * hfunc2.diagonal().array().log().sum();
+
+  // the dense triangular product is faster unless most coefficients are zero
+  size_t nnz = static_cast<size_t>((hfunc2.array() != 0.0).count());
+  dense_ = (8 * nnz > d_ * d_);
+  if (dense_) {
+    coefs_ = std::move(hfunc2);
+    return;
+  }
+  starts_.reserve(d_ + 1);
+  rows_.reserve(nnz);
+  values_.reserve(nnz);
+  for (size_t j = 0; j < d_; ++j) {
+    starts_.push_back(rows_.size());
+    for (size_t i = j; i < d_; ++i) {
+      if (hfunc2(i, j) != 0.0) {
+        rows_.push_back(i);
+        values_.push_back(hfunc2(i, j));
+      }
+    }
+  }
+  starts_.push_back(rows_.size());
+}
+
+//! @brief Gets the dimension of the model (zero for an empty plan).
+inline size_t
+GaussianPlan::get_dim() const
+{
+  return d_;
+}
+
+//! @brief Evaluates the copula density.
+//! @param u An \f$ n \times d \f$ matrix of evaluation points (in natural
+//!   order).
+inline Eigen::VectorXd
+GaussianPlan::pdf(const Eigen::Ref<const Eigen::MatrixXd>& u) const
+{
+  return logpdf(u).array().exp();
+}
+
+//! @brief Evaluates the logarithm of the copula density.
+//! @param u An \f$ n \times d \f$ matrix of evaluation points (in natural
+//!   order).
+inline Eigen::VectorXd
+GaussianPlan::logpdf(const Eigen::Ref<const Eigen::MatrixXd>& u) const
+{
+  Eigen::MatrixXd z = to_normal(u);
+  Eigen::MatrixXd w = whiten(z);
+  Eigen::ArrayXd sq =
+    (w.array().square() - z.array().square()).rowwise().sum();
+  return -0.5 * (sq + log_det_);
+}
+
+//! @brief Evaluates the Rosenblatt transform.
+//! @param u An \f$ n \times d \f$ matrix of evaluation points (in natural
+//!   order).
+inline Eigen::MatrixXd
+GaussianPlan::rosenblatt(const Eigen::Ref<const Eigen::MatrixXd>& u) const
+{
+  return tools_stats::pnorm(whiten(to_normal(u)));
+}
+
+//! @brief Evaluates the inverse Rosenblatt transform.
+//! @param u An \f$ n \times d \f$ matrix of evaluation points (in natural
+//!   order).
+inline Eigen::MatrixXd
+GaussianPlan::inverse_rosenblatt(
+  const Eigen::Ref<const Eigen::MatrixXd>& u) const
+{
+  return tools_stats::pnorm(unwhiten(to_normal(u)));
+}
+
+//! @brief Transforms data to the normal scale (after trimming them to
+//! \f$ [10^{-10}, 1 - 10^{-10}] \f$ like `Bicop` does).
+inline Eigen::MatrixXd
+GaussianPlan::to_normal(const Eigen::Ref<const Eigen::MatrixXd>& u) const
+{
+  Eigen::MatrixXd z = u;
+  tools_eigen::trim(z);
+  return tools_stats::qnorm(z);
+}
+
+//! @brief Computes \f$ w = z C \f$.
+inline Eigen::MatrixXd
+GaussianPlan::whiten(const Eigen::MatrixXd& z) const
+{
+  if (dense_) {
+    return z * coefs_.triangularView<Eigen::Lower>();
+  }
+  Eigen::MatrixXd w(z.rows(), d_);
+  for (size_t j = 0; j < d_; ++j) {
+    w.col(j) = values_[starts_[j]] * z.col(j);
+    for (size_t k = starts_[j] + 1; k < starts_[j + 1]; ++k) {
+      w.col(j) += values_[k] * z.col(rows_[k]);
+    }
+  }
+  return w;
+}
+
+//! @brief Solves \f$ w = z C \f$ for \f$ z \f$.
+inline Eigen::MatrixXd
+GaussianPlan::unwhiten(const Eigen::MatrixXd& w) const
+{
+  Eigen::MatrixXd z = w;
+  if (dense_) {
+    coefs_.triangularView<Eigen::Lower>().solveInPlace<Eigen::OnTheRight>(z);
+    return z;
+  }
+  // column j only depends on the columns to its right
+  for (size_t j = d_; j-- > 0;) {
+    for (size_t k = starts_[j] + 1; k < starts_[j + 1]; ++k) {
+      z.col(j) -= values_[k] * z.col(rows_[k]);
+    }
+    z.col(j) /= values_[starts_[j]];
+  }
+  return z;
+}
+}
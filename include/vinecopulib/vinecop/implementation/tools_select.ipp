@@ -27,6 +27,24 @@ calculate_criterion(const Eigen::MatrixXd& data,
                     std::string tree_criterion,
                     Eigen::VectorXd weights)
 {
+  double tau;
+  return calculate_criterion(data, tree_criterion, weights, tau);
+}
+
+//! @brief Calculates criterion for tree selection.
+//! @param data Observations.
+//! @param tree_criterion The criterion.
+//! @param weights Vector of weights for each observation (can be empty).
+//! @param tau Set to Kendall's tau of the first two columns of `data` (after
+//!   removing missing values) if it is computed along the way, `NAN`
+//!   otherwise.
+inline double
+calculate_criterion(const Eigen::MatrixXd& data,
+                    std::string tree_criterion,
+                    Eigen::VectorXd weights,
+                    double& tau)
+{
+  tau = NAN;
   double w = 0.0;
   Eigen::MatrixXd data_no_nan = data;
   tools_eigen::remove_nans(data_no_nan, weights);
@@ -41,6 +59,9 @@ calculate_criterion(const Eigen::MatrixXd& data,
       w = -0.5 * std::log(1 - w * w);
     } else {
       w = wdm::wdm(data_no_nan, tree_criterion, weights)(0, 1);
+      if (tree_criterion == "tau") {
+        tau = w;
+      }
     }
 
     if (std::isnan(w)) {
@@ -78,13 +99,13 @@ calculate_criterion_matrix(const Eigen::MatrixXd& data,
 
 //! computes
 inline std::vector<size_t>
-get_disc_cols(std::vector<std::string> var_types)
+get_disc_cols(const std::vector<VarType>& var_types)
 {
   size_t d = var_types.size();
   std::vector<size_t> disc_cols(d);
   size_t disc_count = 0;
   for (size_t i = 0; i < d; ++i) {
-    if (var_types[i] == "d") {
+    if (var_types[i] == VarType::discrete) {
       disc_cols[i] = disc_count++;
     } else {
       disc_cols[i] = 0;
@@ -95,7 +116,7 @@ get_disc_cols(std::vector<std::string> var_types)
 
 inline VinecopSelector::VinecopSelector(const Eigen::MatrixXd& data,
                                         const FitControlsVinecop& controls,
-                                        std::vector<std::string> var_types)
+                                        const std::vector<VarType>& var_types)
   : n_(data.rows())
   , d_(var_types.size())
   , var_types_(var_types)
@@ -111,7 +132,7 @@ inline VinecopSelector::VinecopSelector(const Eigen::MatrixXd& data,
 inline VinecopSelector::VinecopSelector(const Eigen::MatrixXd& data,
                                         const RVineStructure& vine_struct,
                                         const FitControlsVinecop& controls,
-                                        std::vector<std::string> var_types)
+                                        const std::vector<VarType>& var_types)
   : VinecopSelector(data, controls, var_types)
 {
   vine_struct_ = vine_struct;
@@ -371,14 +392,16 @@ VinecopSelector::add_allowed_edges(VineTree& vine_tree)
         // (-1 means 'no common neighbor')
         if (find_common_neighbor(v0, v1, vine_tree) > -1) {
           auto pc_data = get_pc_data(v0, v1, vine_tree);
+          double tau;
           double crit = calculate_criterion(
-            pc_data, tree_criterion, controls_.get_weights());
+            pc_data, tree_criterion, controls_.get_weights(), tau);
           double w = 1.0 - static_cast<double>(crit >= threshold) * crit;
           {
             std::lock_guard<std::mutex> lk(m);
             auto e = boost::add_edge(v0, v1, w, vine_tree).first;
             vine_tree[e].weight = w;
             vine_tree[e].crit = crit;
+            vine_tree[e].tau = tau;
           }
         }
       }
@@ -396,10 +419,12 @@ VinecopSelector::add_allowed_edges(VineTree& vine_tree)
         size_t v1 = vine_struct_.min_array(tree, v0) - 1;
         Eigen::MatrixXd pc_data = get_pc_data(v0, v1, vine_tree);
         EdgeIterator e = boost::add_edge(v0, v1, 1.0, vine_tree).first;
+        double tau;
         double crit = calculate_criterion(
-          pc_data.leftCols(2), tree_criterion, controls_.get_weights());
+          pc_data.leftCols(2), tree_criterion, controls_.get_weights(), tau);
         vine_tree[e].weight = 1.0;
         vine_tree[e].crit = crit;
+        vine_tree[e].tau = tau;
       }
     }
   }
@@ -564,13 +589,14 @@ VinecopSelector::add_pc_info(const EdgeIterator& e, VineTree& tree)
   ptrdiff_t pos0 = find_position(ei_common, tree[v0].prev_edge_indices);
   ptrdiff_t pos1 = find_position(ei_common, tree[v1].prev_edge_indices);
 
-  tree[e].var_types[0] = tree[v0].var_types[std::abs(1 - pos0)];
-  tree[e].var_types[1] = tree[v1].var_types[std::abs(1 - pos1)];
+  auto type0 = get_var_type(tree[v0].var_types, pos0 == 0);
+  auto type1 = get_var_type(tree[v1].var_types, pos1 == 0);
+  tree[e].var_types = get_var_type_pair(type0, type1);
 
   // collect pseudo observations for next tree
   tree[e].pc_data.col(0) = get_hfunc(tree[v0], pos0 == 0);
   tree[e].pc_data.col(1) = get_hfunc(tree[v1], pos1 == 0);
-  if ((tree[e].var_types[0] == "d") | (tree[e].var_types[1] == "d")) {
+  if (tree[e].var_types != VarTypePair::cc) {
     tree[e].pc_data.conservativeResize(n, 4);
     tree[e].pc_data.col(2) = get_hfunc_sub(tree[v0], pos0 == 0);
     tree[e].pc_data.col(3) = get_hfunc_sub(tree[v1], pos1 == 0);
@@ -611,6 +637,29 @@ VinecopSelector::get_hfunc_sub(const VertexProperties& vertex_data,
   }
 }
 
+//! @brief Sets the h-functions of an edge with independence copula.
+//!
+//! The h-functions of the independence copula are the arguments themselves,
+//! so no evaluation of the pair copula is required.
+inline void
+VinecopSelector::set_indep_hfuncs(EdgeProperties& edge)
+{
+  auto first = [](double u1, double) { return u1; };
+  auto second = [](double, double u2) { return u2; };
+  Eigen::MatrixXd u = edge.pc_data.leftCols(2);
+  edge.hfunc1 = tools_eigen::binaryExpr_or_nan(u, second);
+  edge.hfunc2 = tools_eigen::binaryExpr_or_nan(u, first);
+  if (is_discrete(edge.var_types, 1)) {
+    u.col(1) = edge.pc_data.col(3);
+    edge.hfunc1_sub = tools_eigen::binaryExpr_or_nan(u, second);
+    u.col(1) = edge.pc_data.col(1);
+  }
+  if (is_discrete(edge.var_types, 0)) {
+    u.col(0) = edge.pc_data.col(2);
+    edge.hfunc2_sub = tools_eigen::binaryExpr_or_nan(u, first);
+  }
+}
+
 inline Eigen::MatrixXd
 VinecopSelector::get_pc_data(size_t v0, size_t v1, const VineTree& tree)
 {
@@ -797,9 +846,9 @@ VinecopSelector::make_base_tree(const Eigen::MatrixXd& data)
     // data need are reordered to correspond to natural order (neccessary
     // when structure is fixed)
     base_tree[e].hfunc1 = data.col(order[target] - 1);
-    if (var_types_[order[target] - 1] == "d") {
+    if (var_types_[order[target] - 1] == VarType::discrete) {
       base_tree[e].hfunc1_sub = data.col(d_ + disc_cols[order[target] - 1]);
-      base_tree[e].var_types = { "d", "d" };
+      base_tree[e].var_types = VarTypePair::dd;
     }
 
     // identify edge with variable "target" and initialize sets
@@ -969,32 +1018,108 @@ VinecopSelector::select_pair_copulas(VineTree& tree, const VineTree& tree_opt)
 
     if (!used_old_fit) {
       tree[e].pair_copula = vinecopulib::Bicop();
-      tree[e].pair_copula.set_var_types(tree[e].var_types);
+      tree[e].pair_copula.set_var_type_pair(tree[e].var_types);
       if (!is_thresholded) {
-        tree[e].pair_copula.select(tree[e].pc_data, controls_);
+        tree[e].pair_copula.select(
+          tree[e].pc_data, controls_, get_cached_tau(tree[e]));
       }
     }
 
-    tree[e].hfunc1 = tree[e].pair_copula.hfunc1(tree[e].pc_data);
-    tree[e].hfunc2 = tree[e].pair_copula.hfunc2(tree[e].pc_data);
-    if (tree[e].var_types[1] == "d") {
+    if (tree[e].pair_copula.get_family() == BicopFamily::indep) {
+      set_indep_hfuncs(tree[e]);
+      return;
+    }
+
+    // both h-functions are evaluated together
+    Eigen::VectorXd no_pdf;
+    tree[e].hfunc1.resize(tree[e].pc_data.rows());
+    tree[e].hfunc2.resize(tree[e].pc_data.rows());
+    tree[e].pair_copula.evaluate(
+      tree[e].pc_data, no_pdf, tree[e].hfunc1, tree[e].hfunc2, false);
+    if (is_discrete(tree[e].var_types, 1)) {
       auto sub_data = tree[e].pc_data;
       sub_data.col(1) = sub_data.col(3);
       tree[e].hfunc1_sub = tree[e].pair_copula.hfunc1(sub_data);
     }
-    if (tree[e].var_types[0] == "d") {
+    if (is_discrete(tree[e].var_types, 0)) {
       auto sub_data = tree[e].pc_data;
       sub_data.col(0) = sub_data.col(2);
       tree[e].hfunc2_sub = tree[e].pair_copula.hfunc2(sub_data);
     }
   };
 
-  // make sure that Bicop.select() doesn't spawn new threads
+  // expensive edges are processed first, cheap ones fill the gaps at the end
+  std::vector<EdgeIterator> edges;
+  std::vector<double> costs;
+  for (auto e : boost::edges(tree)) {
+    edges.push_back(e);
+    costs.push_back(estimate_select_cost(tree[e]));
+  }
+  auto select_batch = [&](const std::vector<size_t>& batch) {
+    for (auto i : batch) {
+      select_pc(edges[i]);
+    }
+  };
+  auto batches =
+    tools_batch::create_batches(costs, controls_.get_num_threads());
+
+  // Bicop.select() runs its jobs on the same global worker pool; RcppThread's
+  // pools would spawn new threads, so parallel selection is disabled there
+#ifdef INTERFACED_FROM_R
   size_t num_threads = controls_.get_num_threads();
   controls_.set_num_threads(0);
-  pool_.map(select_pc, boost::edges(tree));
+#endif
+  pool_.map(select_batch, batches);
   pool_.wait();
+#ifdef INTERFACED_FROM_R
   controls_.set_num_threads(num_threads);
+#endif
+}
+
+//! @brief Estimates the cost of selecting the pair copula of an edge.
+//!
+//! The estimate is the number of observations times the cost of fitting
+//! all candidate families (see `tools_select::get_fit_cost()`); edges that
+//! are thresholded only require an independence model.
+//! @param edge The edge properties.
+inline double
+VinecopSelector::estimate_select_cost(const EdgeProperties& edge) const
+{
+  double cost = 1.0;
+  if (!(edge.crit < controls_.get_threshold())) {
+    auto families = controls_.get_family_set();
+    if (families.empty()) {
+      families = bicop_families::all;
+    }
+    for (auto family : families) {
+      // most families are fit with two rotations
+      double num_rotations =
+        tools_stl::is_member(family, bicop_families::rotationless) ? 1.0 : 2.0;
+      cost += num_rotations * tools_select::get_fit_cost(family, controls_);
+    }
+  }
+  return cost * static_cast<double>(edge.pc_data.rows());
+}
+
+//! @brief Returns Kendall's tau of an edge's data as computed for the tree
+//! criterion, if `Bicop::select()` would compute the same value.
+//!
+//! `Bicop::select()` removes rows with missing values in any column and
+//! trims the data before computing Kendall's tau; the cached value is only
+//! used when neither changes the data.
+//! @param edge The edge properties.
+//! @return the cached value or `NAN`.
+inline double
+VinecopSelector::get_cached_tau(const EdgeProperties& edge) const
+{
+  if (std::isnan(edge.tau) || edge.pc_data.hasNaN()) {
+    return NAN;
+  }
+  auto u = edge.pc_data.leftCols(2).array();
+  if ((u < 1e-10).any() || (u > 1 - 1e-10).any()) {
+    return NAN;
+  }
+  return edge.tau;
 }
 
 //! @brief Finds the fitted pair-copula from the previous iteration.
@@ -37,13 +37,19 @@ calculate_criterion(const Eigen::MatrixXd& data,
                     std::string tree_criterion,
                     Eigen::VectorXd weights);
 
+double
+calculate_criterion(const Eigen::MatrixXd& data,
+                    std::string tree_criterion,
+                    Eigen::VectorXd weights,
+                    double& tau);
+
 Eigen::MatrixXd
 calculate_criterion_matrix(const Eigen::MatrixXd& data,
                            const std::string& tree_criterion,
                            const Eigen::VectorXd& weights);
 
 std::vector<size_t>
-get_disc_cols(std::vector<std::string> var_types);
+get_disc_cols(const std::vector<VarType>& var_types);
 
 // boost::graph represenation of a vine tree
 struct VertexProperties
@@ -56,7 +62,7 @@ struct VertexProperties
   Eigen::VectorXd hfunc2;
   Eigen::VectorXd hfunc1_sub;
   Eigen::VectorXd hfunc2_sub;
-  std::vector<std::string> var_types{ "c", "c" };
+  VarTypePair var_types{ VarTypePair::cc };
 };
 struct EdgeProperties
 {
@@ -68,9 +74,10 @@ struct EdgeProperties
   Eigen::VectorXd hfunc2;
   Eigen::VectorXd hfunc1_sub;
   Eigen::VectorXd hfunc2_sub;
-  std::vector<std::string> var_types{ "c", "c" };
+  VarTypePair var_types{ VarTypePair::cc };
   double weight;
   double crit;
+  double tau{ NAN }; // Kendall's tau of `pc_data` (if known)
   vinecopulib::Bicop pair_copula;
   double fit_id;
 };
@@ -90,12 +97,12 @@ class VinecopSelector
 public:
   VinecopSelector(const Eigen::MatrixXd& data,
                   const FitControlsVinecop& controls,
-                  std::vector<std::string> var_types);
+                  const std::vector<VarType>& var_types);
 
   VinecopSelector(const Eigen::MatrixXd& data,
                   const RVineStructure& vine_struct,
                   const FitControlsVinecop& controls,
-                  std::vector<std::string> var_types);
+                  const std::vector<VarType>& var_types);
 
   std::vector<std::vector<Bicop>> get_pair_copulas() const;
 
@@ -150,6 +157,8 @@ protected:
   Eigen::VectorXd get_hfunc_sub(const VertexProperties& vertex_data,
                                 bool is_first);
 
+  void set_indep_hfuncs(EdgeProperties& edge);
+
   ptrdiff_t find_common_neighbor(size_t v0, size_t v1, const VineTree& tree);
 
   virtual double compute_fit_id(const EdgeProperties& e);
@@ -157,7 +166,7 @@ protected:
   size_t n_;
   size_t d_;
   bool structure_known_{ true };
-  std::vector<std::string> var_types_;
+  std::vector<VarType> var_types_;
   FitControlsVinecop controls_;
   tools_thread::ThreadPool pool_;
   std::vector<VineTree> trees_;
@@ -189,6 +198,9 @@ protected:
   void select_pair_copulas(VineTree& tree,
                            const VineTree& tree_opt = VineTree());
 
+  double estimate_select_cost(const EdgeProperties& edge) const;
+  double get_cached_tau(const EdgeProperties& edge) const;
+
   FoundEdge find_old_fit(double fit_id, const VineTree& old_graph);
 
   double get_tree_loglik(const VineTree& tree);
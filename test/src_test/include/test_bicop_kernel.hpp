@@ -78,6 +78,44 @@ TEST_P(TrafokernelTest, flip)
   EXPECT_TRUE(pdf.isApprox(pdf_flipped, 1e-10));
 }
 
+TEST_P(TrafokernelTest, integrals)
+{
+  // the initial grid corresponds to the independence copula
+  Eigen::VectorXd indep_cdf = u.col(0).cwiseProduct(u.col(1));
+  EXPECT_TRUE(bicop_.cdf(u).isApprox(indep_cdf, 1e-10));
+  EXPECT_TRUE(bicop_.hfunc1(u).isApprox(u.col(1), 1e-10));
+
+  // integrals are updated when the model is flipped
+  bicop_.fit(u, controls);
+  auto cdf = bicop_.cdf(u);
+  auto hfunc1 = bicop_.hfunc1(u);
+  u.col(0).swap(u.col(1));
+  bicop_.flip();
+  EXPECT_LT((cdf - bicop_.cdf(u)).cwiseAbs().maxCoeff(), 1e-3);
+  EXPECT_TRUE(hfunc1.isApprox(bicop_.hfunc2(u), 1e-10));
+}
+
+TEST_P(TrafokernelTest, binned)
+{
+  auto data = Bicop(BicopFamily::gaussian, 0, Eigen::VectorXd::Constant(1, 0.5))
+                .simulate(2000, false, { 2 });
+  auto exact = Bicop(data, controls);
+  controls.set_nonparametric_binned(true);
+  auto binned = Bicop(data, controls);
+  EXPECT_NEAR(binned.get_loglik(), binned.loglik(data), 1e-5);
+  EXPECT_NEAR(binned.get_loglik(), exact.get_loglik(), 1.0);
+  EXPECT_NEAR(binned.get_npars(), exact.get_npars(), 0.5);
+
+  auto grid = tools_eigen::expand_grid(Eigen::VectorXd::LinSpaced(9, 0.1, 0.9));
+  auto pdf_exact = exact.pdf(grid);
+  EXPECT_TRUE(binned.pdf(grid).isApprox(pdf_exact, 0.02));
+
+  // weights and small samples
+  controls.set_weights(Eigen::VectorXd::Constant(20, 1.0));
+  bicop_.fit(u, controls);
+  EXPECT_GE(bicop_.pdf(u).minCoeff(), 0.0);
+}
+
 TEST_P(TrafokernelTest, tau)
 {
   double tau = bicop_.parameters_to_tau(bicop_.get_parameters());
@@ -99,4 +137,37 @@ TEST_P(TrafokernelTest, reset)
 INSTANTIATE_TEST_SUITE_P(TrafokernelTest,
                          TrafokernelTest,
                          ::testing::Values("constant", "linear", "quadratic"));
+
+TEST(interpolation_grid, lookup_methods_agree)
+{
+  // bilinear functions are reproduced exactly by the interpolation
+  size_t m = 30;
+  auto f = [](double x, double y) { return 1.0 + x + 2.0 * y; };
+  Eigen::VectorXd normal_grid(m);
+  for (size_t i = 0; i < m; ++i) {
+    normal_grid(i) =
+      -3.25 + static_cast<double>(i) * 6.5 / static_cast<double>(m - 1);
+  }
+  normal_grid = tools_stats::pnorm(normal_grid);
+  normal_grid(0) = 0.0;
+  normal_grid(m - 1) = 1.0;
+  Eigen::VectorXd uneven_grid = Eigen::VectorXd::LinSpaced(m, 0.0, 1.0);
+  uneven_grid(1) = 1e-8; // forces binary search
+
+  auto u = tools_stats::simulate_uniform(1000, 2, false, { 1 });
+  u.topRows(m).col(0) = normal_grid;
+  u.block(m, 0, m, 1) = uneven_grid;
+  Eigen::VectorXd expected = u.col(0) + 2.0 * u.col(1);
+  expected.array() += 1.0;
+  for (auto grid : { normal_grid, uneven_grid }) {
+    Eigen::MatrixXd values(m, m);
+    for (size_t i = 0; i < m; ++i) {
+      for (size_t j = 0; j < m; ++j) {
+        values(i, j) = f(grid(i), grid(j));
+      }
+    }
+    tools_interpolation::InterpolationGrid interp_grid(grid, values, 0);
+    EXPECT_TRUE(interp_grid.interpolate(u).isApprox(expected, 1e-12));
+  }
+}
 }
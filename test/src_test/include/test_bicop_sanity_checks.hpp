@@ -9,6 +9,7 @@
 #include "gtest/gtest.h"
 #include <vinecopulib/bicop/class.hpp>
 #include <vinecopulib/misc/tools_stats.hpp>
+#include <vinecopulib/misc/tools_stl.hpp>
 
 namespace test_bicop_sanity_checks {
 using namespace vinecopulib;
@@ -47,6 +48,27 @@ TEST(bicop_sanity_checks, catches_var_types)
   EXPECT_ANY_THROW(Bicop(BicopFamily::gaussian, 0, rho, { "c", "u" }));
 }
 
+TEST(bicop_sanity_checks, var_types_are_converted)
+{
+  std::vector<std::string> cd = { "c", "d" };
+  EXPECT_EQ(get_var_type_pair(cd), VarTypePair::cd);
+  EXPECT_EQ(get_var_type_names(VarTypePair::cd), cd);
+  EXPECT_EQ(flip_var_types(VarTypePair::cd), VarTypePair::dc);
+  EXPECT_EQ(count_discrete(VarTypePair::dd), 2);
+  EXPECT_EQ(get_var_type_names(get_var_type_enums(cd)), cd);
+  EXPECT_ANY_THROW(get_var_type_enum("u"));
+
+  // types are kept through rotations, flips, and copies
+  auto bc = Bicop(BicopFamily::clayton, 90, Eigen::VectorXd::Constant(1, 3));
+  bc.set_var_types(cd);
+  EXPECT_EQ(bc.get_var_types(), cd);
+  bc.flip();
+  EXPECT_EQ(bc.get_var_types(), std::vector<std::string>({ "d", "c" }));
+  auto bc_copy = bc;
+  EXPECT_EQ(bc_copy.get_var_types(), bc.get_var_types());
+  EXPECT_EQ(Bicop(bc.to_ptree()).get_var_types(), bc.get_var_types());
+}
+
 TEST(bicop_sanity_checks, catches_data_dim)
 {
   Bicop bicop;
@@ -96,4 +118,223 @@ TEST(bicop_sanity_checks, copy)
   EXPECT_EQ(bc2.get_loglik(), bc3.get_loglik());
   EXPECT_EQ(bc2.get_nobs(), bc3.get_nobs());
 }
+
+TEST(bicop_sanity_checks, evaluates_into_buffers)
+{
+  auto u = tools_stats::simulate_uniform(20, 4, false, { 1 });
+  u.col(2) = (u.col(0).array() - 0.05).max(0.0);
+  u.col(3) = (u.col(1).array() - 0.05).max(0.0);
+  Eigen::MatrixXd u_swapped = u;
+  u_swapped.col(0).swap(u_swapped.col(1));
+  u_swapped.col(2).swap(u_swapped.col(3));
+
+  // columns of a larger matrix can be used as input and output
+  Eigen::MatrixXd data(20, 6), out(20, 3);
+  data.middleCols(1, 4) = u;
+
+  Bicop bc(BicopFamily::clayton, 0, Eigen::VectorXd::Constant(1, 3.0));
+  for (auto rot : { 0, 90, 180, 270 }) {
+    bc.set_rotation(rot);
+    for (auto types : std::vector<std::vector<std::string>>{
+           { "c", "c" }, { "c", "d" }, { "d", "c" }, { "d", "d" } }) {
+      bc.set_var_types(types);
+      bc.pdf(data.middleCols(1, 4), out.col(0));
+      bc.hfunc1(data.middleCols(1, 4), out.col(1));
+      bc.hfunc2(data.middleCols(1, 4), out.col(2));
+      EXPECT_TRUE(out.col(0).isApprox(bc.pdf(u)));
+      EXPECT_TRUE(out.col(1).isApprox(bc.hfunc1(u)));
+      EXPECT_TRUE(out.col(2).isApprox(bc.hfunc2(u)));
+    }
+    bc.set_var_types({ "c", "c" });
+    bc.hinv1(data.middleCols(1, 2), out.col(1));
+    bc.hinv2(data.middleCols(1, 2), out.col(2));
+    EXPECT_TRUE(out.col(1).isApprox(bc.hinv1(u.leftCols(2))));
+    EXPECT_TRUE(out.col(2).isApprox(bc.hinv2(u.leftCols(2))));
+  }
+
+  // rotations by 90 and 270 degrees are mirrored versions of each other
+  Bicop bc90(BicopFamily::clayton, 90, Eigen::VectorXd::Constant(1, 3.0));
+  Bicop bc270(BicopFamily::clayton, 270, Eigen::VectorXd::Constant(1, 3.0));
+  EXPECT_TRUE(bc90.pdf(u.leftCols(2)).isApprox(bc270.pdf(u_swapped)));
+  EXPECT_TRUE(bc90.hfunc1(u.leftCols(2)).isApprox(bc270.hfunc2(u_swapped)));
+  EXPECT_TRUE(bc90.hinv2(u.leftCols(2)).isApprox(bc270.hinv1(u_swapped)));
+
+  Eigen::VectorXd too_short(10);
+  EXPECT_ANY_THROW(bc.pdf(u.leftCols(2), too_short));
+}
+
+TEST(bicop_sanity_checks, evaluate_is_consistent)
+{
+  auto u = tools_stats::simulate_uniform(20, 4, false, { 1 });
+  u.col(2) = (u.col(0).array() - 0.05).max(0.0);
+  u.col(3) = (u.col(1).array() - 0.05).max(0.0);
+  Eigen::MatrixXd out(20, 3);
+
+  std::vector<Bicop> bcs = {
+    Bicop(BicopFamily::gaussian, 0, Eigen::VectorXd::Constant(1, 0.5)),
+    Bicop(BicopFamily::student, 0, Eigen::Vector2d(-0.3, 4.5)),
+    Bicop(BicopFamily::clayton, 0, Eigen::VectorXd::Constant(1, 3.0)),
+    Bicop(BicopFamily::bb8, 0, Eigen::Vector2d(3.0, 0.7))
+  };
+  FitControlsBicop controls({ BicopFamily::tll });
+  bcs.push_back(Bicop(bcs[2].simulate(500, false, { 3 }), controls));
+  for (auto& bc : bcs) {
+    for (auto rot : { 0, 90, 180, 270 }) {
+      if (!tools_stl::is_member(bc.get_family(),
+                                bicop_families::rotationless)) {
+        bc.set_rotation(rot);
+      }
+      for (auto types : std::vector<std::vector<std::string>>{
+             { "c", "c" }, { "c", "d" }, { "d", "c" }, { "d", "d" } }) {
+        bc.set_var_types(types);
+        bc.evaluate(u, out.col(0), out.col(1), out.col(2));
+        EXPECT_TRUE(out.col(0).isApprox(bc.pdf(u))) << bc.str();
+        EXPECT_TRUE(out.col(1).isApprox(bc.hfunc1(u))) << bc.str();
+        EXPECT_TRUE(out.col(2).isApprox(bc.hfunc2(u))) << bc.str();
+
+        // outputs that are not requested are left untouched
+        out.setConstant(-1.0);
+        bc.evaluate(u, out.col(0), out.col(1), out.col(2), false, true, false);
+        EXPECT_TRUE(out.col(1).isApprox(bc.hfunc1(u)));
+        EXPECT_EQ(out.col(0), Eigen::VectorXd::Constant(20, -1.0));
+        EXPECT_EQ(out.col(2), Eigen::VectorXd::Constant(20, -1.0));
+      }
+    }
+  }
+}
+
+TEST(bicop_sanity_checks, logpdf_is_log_of_pdf)
+{
+  auto u = tools_stats::simulate_uniform(100, 4, false, { 4 });
+  u.col(2) = (u.col(0).array() - 0.05).max(0.0);
+  u.col(3) = (u.col(1).array() - 0.05).max(0.0);
+  Eigen::MatrixXd out(100, 3);
+
+  for (auto family : bicop_families::parametric) {
+    for (auto rot : { 0, 90, 180, 270 }) {
+      if ((rot > 0) &&
+          tools_stl::is_member(family, bicop_families::rotationless)) {
+        continue;
+      }
+      Bicop bc(family, rot);
+      if (tools_stl::is_member(family, bicop_families::one_par)) {
+        bc.set_parameters(bc.tau_to_parameters(0.3));
+      } else if (family != BicopFamily::indep) {
+        bc.set_parameters(bc.get_parameters_lower_bounds().array() + 0.5);
+      }
+      for (auto types : std::vector<std::vector<std::string>>{
+             { "c", "c" }, { "c", "d" }, { "d", "d" } }) {
+        bc.set_var_types(types);
+        Eigen::VectorXd f = bc.pdf(u).array().log();
+        EXPECT_LT((bc.logpdf(u) - f).cwiseAbs().maxCoeff(), 1e-10)
+          << bc.str();
+        bc.evaluate(u, out.col(0), out.col(1), out.col(2),
+                    true, true, true, true);
+        EXPECT_LT((out.col(0) - f).cwiseAbs().maxCoeff(), 1e-10) << bc.str();
+        EXPECT_TRUE(out.col(1).isApprox(bc.hfunc1(u))) << bc.str();
+      }
+    }
+  }
+}
+
+TEST(bicop_sanity_checks, hinv_inverts_hfunc)
+{
+  auto u = tools_stats::simulate_uniform(200, 2, false, { 2 });
+  std::vector<Bicop> bcs = {
+    Bicop(BicopFamily::frank, 0, Eigen::VectorXd::Constant(1, 8.0)),
+    Bicop(BicopFamily::frank, 0, Eigen::VectorXd::Constant(1, -3.0)),
+    Bicop(BicopFamily::bb1, 0, Eigen::Vector2d(0.5, 1.5)),
+    Bicop(BicopFamily::bb6, 90, Eigen::Vector2d(1.5, 1.5)),
+    Bicop(BicopFamily::bb7, 180, Eigen::Vector2d(1.5, 0.5)),
+    Bicop(BicopFamily::bb8, 270, Eigen::Vector2d(3.0, 0.7))
+  };
+  FitControlsBicop controls({ BicopFamily::tll });
+  bcs.push_back(Bicop(bcs[2].simulate(500, false, { 3 }), controls));
+
+  Eigen::MatrixXd v = u;
+  for (auto& bc : bcs) {
+    v.col(1) = bc.hfunc1(u);
+    EXPECT_LT((bc.hinv1(v) - u.col(1)).cwiseAbs().maxCoeff(), 1e-6)
+      << bc.str();
+    v.col(1) = u.col(1);
+    v.col(0) = bc.hfunc2(u);
+    EXPECT_LT((bc.hinv2(v) - u.col(0)).cwiseAbs().maxCoeff(), 1e-6)
+      << bc.str();
+    v.col(0) = u.col(0);
+  }
+}
+
+TEST(bicop_sanity_checks, copies_are_independent)
+{
+  auto u = tools_stats::simulate_uniform(100, 2, false, { 4 });
+  Bicop clayton(BicopFamily::clayton, 90, Eigen::VectorXd::Constant(1, 2.0));
+  Eigen::VectorXd pdf = clayton.pdf(u);
+
+  Bicop bc = clayton;
+  bc.set_parameters(Eigen::VectorXd::Constant(1, 5.0));
+  bc.set_rotation(180);
+  bc.set_var_types({ "d", "c" });
+  EXPECT_EQ(clayton.get_parameters()(0), 2.0);
+  EXPECT_EQ(clayton.get_rotation(), 90);
+  EXPECT_EQ(clayton.get_var_types(), std::vector<std::string>({ "c", "c" }));
+  EXPECT_EQ(clayton.pdf(u), pdf);
+
+  // modifying the original leaves the copy untouched
+  bc = clayton;
+  clayton.flip();
+  EXPECT_EQ(bc.get_rotation(), 90);
+  EXPECT_EQ(bc.pdf(u), pdf);
+
+  // same for nonparametric models, including the effective number of
+  // parameters
+  Bicop tll(u, FitControlsBicop({ BicopFamily::tll }));
+  Bicop tll_copy = tll;
+  tll_copy.flip();
+  EXPECT_EQ(tll_copy.get_npars(), tll.get_npars());
+  auto u_flipped = u.rowwise().reverse().eval();
+  EXPECT_TRUE(tll_copy.pdf(u_flipped).isApprox(tll.pdf(u)));
+  tll.fit(tools_stats::simulate_uniform(100, 2, false, { 5 }));
+  EXPECT_FALSE(tll_copy.pdf(u_flipped).isApprox(tll.pdf(u)));
+}
+
+TEST(bicop_sanity_checks, mle_with_scores_finds_maximum)
+{
+  std::vector<Bicop> bcs = {
+    Bicop(BicopFamily::gaussian, 0, Eigen::VectorXd::Constant(1, -0.6)),
+    Bicop(BicopFamily::clayton, 0, Eigen::VectorXd::Constant(1, 3.0)),
+    Bicop(BicopFamily::clayton, 90, Eigen::VectorXd::Constant(1, 0.5)),
+    Bicop(BicopFamily::gumbel, 180, Eigen::VectorXd::Constant(1, 2.0)),
+    Bicop(BicopFamily::frank, 0, Eigen::VectorXd::Constant(1, -5.0)),
+    Bicop(BicopFamily::joe, 270, Eigen::VectorXd::Constant(1, 1.8))
+  };
+  for (auto& bc : bcs) {
+    auto u = bc.simulate(1000, false, { 6 });
+    FitControlsBicop controls({ bc.get_family() }, "mle");
+    Bicop fitted(bc.get_family(), bc.get_rotation());
+    fitted.fit(u, controls);
+    auto par = fitted.get_parameters();
+    EXPECT_NEAR(fitted.get_loglik(), fitted.loglik(u), 1e-6) << fitted.str();
+    for (double eps : { -1e-3, 1e-3 }) {
+      Bicop perturbed(fitted.get_family(),
+                      fitted.get_rotation(),
+                      par.array() + eps);
+      EXPECT_LE(perturbed.loglik(u), fitted.get_loglik() + 1e-6)
+        << fitted.str();
+    }
+  }
+}
+
+TEST(bicop_sanity_checks, fitted_loglik_matches_loglik)
+{
+  auto u = tools_stats::simulate_uniform(500, 2, false, { 7 });
+  u(0, 0) = std::numeric_limits<double>::quiet_NaN();
+  for (auto family : bicop_families::parametric) {
+    if (family == BicopFamily::indep) {
+      continue;
+    }
+    Bicop bc(family);
+    bc.fit(u, FitControlsBicop({ family }, "mle"));
+    EXPECT_NEAR(bc.get_loglik(), bc.loglik(u), 1e-8) << bc.str();
+  }
+}
 }
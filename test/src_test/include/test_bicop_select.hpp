@@ -55,4 +55,20 @@ TEST(bicop_select, fit_stats_are_correct)
   EXPECT_NEAR(cop.get_mbic(), cop.mbic(u), 1e-10);
   EXPECT_NEAR(cop.get_mbic(), cop.mbic(), 1e-10);
 }
+
+TEST(bicop_select, racing_finds_same_model)
+{
+  Bicop cop(BicopFamily::clayton, 90, Eigen::VectorXd::Constant(1, 3.0));
+  auto u = cop.simulate(5000, true, { 1 });
+  FitControlsBicop controls(bicop_families::parametric);
+  Bicop fit1(u, controls);
+  controls.set_racing(true);
+  controls.set_num_threads(2);
+  Bicop fit2(u, controls);
+  EXPECT_EQ(fit1.get_family(), fit2.get_family());
+  EXPECT_EQ(fit1.get_rotation(), fit2.get_rotation());
+  EXPECT_EQ(fit1.get_parameters(), fit2.get_parameters());
+  EXPECT_EQ(fit1.get_num_saved_fits(), 0);
+  EXPECT_GT(fit2.get_num_saved_fits(), 0);
+}
 }
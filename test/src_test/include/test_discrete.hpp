@@ -7,6 +7,7 @@
 #pragma once
 
 #include "gtest/gtest.h"
+#include <thread>
 #include <vinecopulib/bicop/class.hpp>
 #include <vinecopulib/vinecop/class.hpp>
 
@@ -127,6 +128,11 @@ TEST(discrete, vinecop)
   u.col(8) = (utmp.col(3).array() * 10).floor() / 10;
   vc.select(u, controls);
   vc.pdf(u);
+
+  // serialization preserves the variable types of the pair-copulas
+  Vinecop vc2(vc.to_ptree());
+  EXPECT_TRUE(vc2.pdf(u).isApprox(vc.pdf(u)));
+
   pcs = vc.get_all_pair_copulas();
   for (size_t t = 0; t < 4; t++) {
     for (auto pc : pcs[t]) {
@@ -136,4 +142,49 @@ TEST(discrete, vinecop)
     }
   }
 }
+
+TEST(discrete, shared_model_is_thread_safe)
+{
+  auto pair_copulas = Vinecop::make_pair_copula_store(5);
+  for (auto& tree : pair_copulas) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 90, Eigen::VectorXd::Constant(1, 2));
+    }
+  }
+  RVineStructure str(std::vector<size_t>{ 1, 2, 3, 4, 5 });
+  const Vinecop vc(str, pair_copulas, { "d", "c", "d", "d", "c" });
+
+  Eigen::MatrixXd u(100, 8);
+  u.leftCols(5) = vc.simulate(100, true, 1, { 1 });
+  size_t k = 5;
+  for (size_t j : { 0, 2, 3 }) {
+    u.col(k++) = (u.col(j).array() * 10).floor() / 10;
+    u.col(j) = (u.col(j).array() * 10).ceil() / 10;
+  }
+  auto sim = vc.simulate(100, false, 1, { 2 });
+  auto pdf = vc.pdf(u);
+  auto cdf = vc.cdf(u, 500, 1, { 3 });
+
+  // concurrent evaluations on the same object give the serial results
+  std::vector<int> ok(8, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < ok.size(); ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < 10; ++i) {
+        bool same = (vc.simulate(100, false, 1, { 2 }) == sim);
+        same &= (vc.pdf(u) == pdf);
+        same &= (vc.cdf(u, 500, 1, { 3 }) == cdf);
+        ok[t] += same;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto n_ok : ok) {
+    EXPECT_EQ(n_ok, 10);
+  }
+  EXPECT_EQ(vc.get_var_types(),
+            std::vector<std::string>({ "d", "c", "d", "d", "c" }));
+}
 }
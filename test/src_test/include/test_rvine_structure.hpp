@@ -8,6 +8,7 @@
 
 #include "gtest/gtest.h"
 #include <vinecopulib/misc/tools_stl.hpp>
+#include <vinecopulib/vinecop/evaluation_plan.hpp>
 #include <vinecopulib/vinecop/rvine_structure.hpp>
 
 namespace test_rvine_structure {
@@ -147,6 +148,100 @@ TEST(rvine_structure, needed_hfunc2_is_correct)
   EXPECT_EQ(rvine_structure.get_needed_hfunc2().get_trunc_lvl(), 2);
 }
 
+TEST(rvine_structure, evaluation_plan_is_correct)
+{
+  Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic> mat(7, 7);
+  mat << 5, 2, 6, 6, 6, 6, 6, 6, 6, 1, 2, 5, 5, 0, 2, 5, 2, 5, 2, 0, 0, 1, 1, 5,
+    1, 0, 0, 0, 3, 7, 7, 0, 0, 0, 0, 7, 3, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0;
+  RVineStructure rvine_structure(mat);
+
+  auto var_types =
+    get_var_type_enums({ "c", "d", "c", "c", "d", "c", "c" });
+  EvaluationPlan plan(rvine_structure, var_types);
+  EXPECT_EQ(plan.get_steps().size(), 21);
+  EXPECT_TRUE(plan.has_discrete());
+
+  // variables 2 and 5 are discrete (columns 7 and 8 of the collapsed data)
+  auto order = rvine_structure.get_order();
+  auto is_disc = [&](size_t j) { return (order[j] == 2) | (order[j] == 5); };
+  for (size_t j = 0; j < 7; ++j) {
+    EXPECT_EQ(plan.get_input_cols()[j], order[j] - 1);
+    EXPECT_EQ(plan.get_output_cols()[order[j] - 1], j);
+    ptrdiff_t sub_col = (order[j] == 2) ? 7 : ((order[j] == 5) ? 8 : -1);
+    EXPECT_EQ(plan.get_input_sub_cols()[j], sub_col);
+  }
+
+  for (size_t t = 0; t < 6; ++t) {
+    for (size_t e = 0; e < 6 - t; ++e) {
+      auto step = plan.get_step(t, e);
+      size_t m = rvine_structure.min_array(t, e);
+      EXPECT_EQ(step.tree, t);
+      EXPECT_EQ(step.edge, e);
+      EXPECT_EQ(step.arg_col, m - 1);
+      EXPECT_EQ(step.arg_hfunc2, m == rvine_structure.struct_array(t, e, true));
+      EXPECT_EQ(step.needs_hfunc1, rvine_structure.needed_hfunc1(t, e));
+      EXPECT_EQ(step.needs_hfunc2, rvine_structure.needed_hfunc2(t, e));
+      if (t == 0) {
+        EXPECT_EQ(step.disc1, is_disc(e));
+        EXPECT_EQ(step.disc2,
+                  is_disc(rvine_structure.struct_array(0, e, true) - 1));
+      }
+    }
+  }
+
+  rvine_structure.truncate(2);
+  plan = EvaluationPlan(rvine_structure);
+  EXPECT_EQ(plan.get_trunc_lvl(), 2);
+  EXPECT_EQ(plan.get_steps().size(), 11);
+  EXPECT_FALSE(plan.has_discrete());
+}
+
+TEST(rvine_structure, evaluation_plan_tracks_independence)
+{
+  auto rvine_structure = RVineStructure::simulate(7, false, { 3 });
+  std::vector<std::vector<bool>> indep(6);
+  for (size_t t = 0; t < 6; ++t) {
+    indep[t] = std::vector<bool>(6 - t, false);
+  }
+
+  // without independence, all needed h-functions are live
+  EvaluationPlan plan(rvine_structure, {}, indep);
+  for (const auto& step : plan.get_steps()) {
+    EXPECT_FALSE(step.indep);
+    EXPECT_EQ(step.live_hfunc1, step.needs_hfunc1);
+    EXPECT_EQ(step.live_hfunc2, step.needs_hfunc2);
+  }
+
+  // with only independence, no h-function is live
+  for (size_t t = 0; t < 6; ++t) {
+    indep[t] = std::vector<bool>(6 - t, true);
+  }
+  plan = EvaluationPlan(rvine_structure, {}, indep);
+  for (const auto& step : plan.get_steps()) {
+    EXPECT_TRUE(step.indep);
+    EXPECT_FALSE(step.live_hfunc1 | step.live_hfunc2);
+  }
+
+  // a single dependent edge in the last tree keeps its inputs alive
+  indep[5][0] = false;
+  plan = EvaluationPlan(rvine_structure, {}, indep);
+  for (size_t t = 0; t < 5; ++t) {
+    for (size_t e = 0; e < 6 - t; ++e) {
+      auto step = plan.get_step(t, e);
+      EXPECT_TRUE(!step.live_hfunc1 | step.needs_hfunc1);
+      EXPECT_TRUE(!step.live_hfunc2 | step.needs_hfunc2);
+    }
+  }
+  auto last = plan.get_step(5, 0);
+  EXPECT_FALSE(last.indep);
+  EXPECT_TRUE(plan.get_step(4, 0).live_hfunc2);
+  if (last.arg_hfunc2) {
+    EXPECT_TRUE(plan.get_step(4, last.arg_col).live_hfunc2);
+  } else {
+    EXPECT_TRUE(plan.get_step(4, last.arg_col).live_hfunc1);
+  }
+}
+
 TEST(rvine_structure, construct_d_vine_struct_is_correct)
 {
 
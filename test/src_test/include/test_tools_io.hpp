@@ -0,0 +1,94 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include "gtest/gtest.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <vinecopulib/misc/tools_io.hpp>
+#include <vinecopulib/misc/tools_stats.hpp>
+#include <vinecopulib/vinecop/class.hpp>
+
+namespace test_tools_io {
+
+using namespace vinecopulib;
+
+TEST(test_tools_io, read_csv_handles_separators)
+{
+  std::ofstream("test_tools_io.csv")
+    << "0.1 0.2\t0.3\n\n0.4,0.5;0.6\r\n  7e-1 , 8 ,9";
+  auto x = tools_io::read_csv("test_tools_io.csv");
+  Eigen::MatrixXd expected(3, 3);
+  expected << 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 8, 9;
+  EXPECT_EQ(x, expected);
+  EXPECT_EQ(tools_eigen::read_matxd("test_tools_io.csv"), expected);
+
+  std::ofstream("test_tools_io.csv") << "0.1 0.2\n0.3\n";
+  EXPECT_ANY_THROW(tools_io::read_csv("test_tools_io.csv"));
+  std::ofstream("test_tools_io.csv") << "0.1 abc\n";
+  EXPECT_ANY_THROW(tools_io::read_csv("test_tools_io.csv"));
+  std::remove("test_tools_io.csv");
+  EXPECT_ANY_THROW(tools_io::read_csv("test_tools_io.csv"));
+}
+
+TEST(test_tools_io, read_csv_in_parallel)
+{
+  // large enough to be split into several chunks
+  auto u = tools_stats::simulate_uniform(100000, 3, false, { 1 });
+  std::ofstream file("test_tools_io.csv");
+  file << std::setprecision(17) << u.format(Eigen::IOFormat(17, 0, ", "));
+  file.close();
+  EXPECT_EQ(tools_io::read_csv("test_tools_io.csv", 4), u);
+  EXPECT_EQ(tools_io::read_csv("test_tools_io.csv", 1), u);
+  std::remove("test_tools_io.csv");
+}
+
+TEST(test_tools_io, binary_round_trip)
+{
+  auto u = tools_stats::simulate_uniform(100, 3, false, { 1 });
+  tools_io::write_binary("test_tools_io.bin", u, { "c", "d", "c" });
+  {
+    tools_io::MappedData mapped("test_tools_io.bin");
+    EXPECT_EQ(mapped.get_rows(), 100);
+    EXPECT_EQ(mapped.get_cols(), 3);
+    EXPECT_EQ(mapped.get_data(), u);
+    std::vector<std::string> var_types{ "c", "d", "c" };
+    EXPECT_EQ(mapped.get_var_types(), var_types);
+  }
+
+  EXPECT_ANY_THROW(tools_io::write_binary("test_tools_io.bin", u, { "c" }));
+  EXPECT_ANY_THROW(
+    tools_io::write_binary("test_tools_io.bin", u, { "c", "x", "c" }));
+
+  // truncated files are detected
+  std::ofstream("test_tools_io.bin", std::ios::binary) << "VCLDATA";
+  EXPECT_ANY_THROW(tools_io::MappedData("test_tools_io.bin"));
+  std::remove("test_tools_io.bin");
+  EXPECT_ANY_THROW(tools_io::MappedData("test_tools_io.bin"));
+}
+
+TEST(test_tools_io, vinecop_on_mapped_data)
+{
+  auto pcs = Vinecop::make_pair_copula_store(3);
+  for (auto& tree : pcs) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::VectorXd::Constant(1, 2.0));
+    }
+  }
+  Vinecop vc(RVineStructure(std::vector<size_t>{ 1, 2, 3 }), pcs);
+  auto u = vc.simulate(100, false, 1, { 1 });
+  tools_io::write_binary("test_tools_io.bin", u);
+  {
+    tools_io::MappedData mapped("test_tools_io.bin");
+    EXPECT_EQ(vc.pdf(mapped.get_data()), vc.pdf(u));
+    EXPECT_EQ(vc.loglik(mapped.get_data()), vc.loglik(u));
+    EXPECT_EQ(vc.rosenblatt(mapped.get_data()), vc.rosenblatt(u));
+  }
+  std::remove("test_tools_io.bin");
+}
+}
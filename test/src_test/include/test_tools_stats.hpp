@@ -9,6 +9,7 @@
 #include "test_vinecop_sanity_checks.hpp"
 #include "gtest/gtest.h"
 #include <vinecopulib/bicop/class.hpp>
+#include <vinecopulib/misc/dominance_index.hpp>
 #include <vinecopulib/misc/tools_stats.hpp>
 #include <vinecopulib/misc/tools_stl.hpp>
 
@@ -75,6 +76,21 @@ TEST(test_tools_stats, qrng_are_correct)
   }
 }
 
+TEST(test_tools_stats, simulation_does_not_depend_on_num_threads)
+{
+  // more than one block of pseudo-random numbers
+  auto u = tools_stats::simulate_uniform(30000, 5, false, { 1, 2 });
+  EXPECT_EQ(tools_stats::simulate_uniform(30000, 5, false, { 1, 2 }, 3), u);
+  EXPECT_EQ(tools_stats::ghalton(1000, 10, { 1 }, 3),
+            tools_stats::ghalton(1000, 10, { 1 }));
+  EXPECT_EQ(tools_stats::sobol(1000, 10, { 1 }, 3),
+            tools_stats::sobol(1000, 10, { 1 }));
+
+  // quasi-random numbers can be extended
+  auto q = tools_stats::ghalton(1000, 10, { 1 });
+  EXPECT_EQ(tools_stats::ghalton(500, 10, { 1 }), q.topRows(500).eval());
+}
+
 TEST(test_tools_stats, mcor_works)
 {
   std::vector<int> seeds = { 1, 2, 3, 4, 5 };
@@ -126,6 +142,40 @@ TEST(test_tools_stats, dpt_are_nan_safe)
   EXPECT_NO_THROW(tools_stats::qt(tools_stats::pt(X, nu), nu));
 }
 
+TEST(test_tools_stats, distributions_are_accurate)
+{
+  // compare with Boost.Math's default (long double) computations
+  Eigen::VectorXd u = Eigen::VectorXd::Random(1000).array() * 0.5 + 0.5;
+  u(0) = 1e-300;
+  u(1) = 1 - 1e-16;
+  Eigen::VectorXd x = 5 * tools_stats::qnorm(u).array().tanh();
+  x(0) = -35;
+  auto check = [](double computed, double exact) {
+    EXPECT_NEAR(computed, exact, 1e-12 * std::max(std::fabs(exact), 1e-300));
+  };
+
+  boost::math::normal norm;
+  Eigen::VectorXd d = tools_stats::dnorm(x), p = tools_stats::pnorm(x),
+                  q = tools_stats::qnorm(u);
+  for (size_t i = 0; i < 1000; i++) {
+    check(d(i), boost::math::pdf(norm, x(i)));
+    check(p(i), boost::math::cdf(norm, x(i)));
+    check(q(i), boost::math::quantile(norm, u(i)));
+  }
+
+  for (double nu : { 2.0, 4.5, 30.0, 1e5 }) {
+    boost::math::students_t t(nu);
+    d = tools_stats::dt(x, nu);
+    p = tools_stats::pt(x, nu);
+    q = tools_stats::qt(u, nu);
+    for (size_t i = 0; i < 1000; i++) {
+      check(d(i), boost::math::pdf(t, x(i)));
+      check(p(i), boost::math::cdf(t, x(i)));
+      check(q(i), boost::math::quantile(t, u(i)));
+    }
+  }
+}
+
 TEST(test_tools_stats, pbvt_and_pbvnorm_are_nan_safe)
 {
   Eigen::MatrixXd X = Eigen::MatrixXd::Random(10, 2);
@@ -135,4 +185,27 @@ TEST(test_tools_stats, pbvt_and_pbvnorm_are_nan_safe)
   EXPECT_NO_THROW(tools_stats::pbvt(X, nu, rho));
   EXPECT_NO_THROW(tools_stats::pbvnorm(X, rho));
 }
+
+TEST(test_tools_stats, dominance_index_is_correct)
+{
+  for (size_t d : { 1, 3, 6 }) {
+    // rounding creates ties
+    Eigen::MatrixXd x = tools_stats::simulate_uniform(2000, d, false, { 1 });
+    x = (x * 20).array().round() / 20;
+    auto q = tools_stats::simulate_uniform(100, d, false, { 2 });
+    q.row(0) = x.row(0);
+    for (size_t leaf_size : { 1, 32 }) {
+      DominanceIndex index(x, leaf_size);
+      EXPECT_EQ(index.get_size(), 2000);
+      EXPECT_EQ(index.get_dim(), d);
+      for (size_t i = 0; i < 100; ++i) {
+        auto dominated = (x.rowwise() - q.row(i)).array() <= 0.0;
+        size_t expected = dominated.rowwise().all().count();
+        EXPECT_EQ(index.count(q.row(i)), expected);
+      }
+    }
+  }
+  DominanceIndex empty(Eigen::MatrixXd(0, 2));
+  EXPECT_EQ(empty.count(Eigen::RowVector2d(1, 1)), 0);
+}
 }
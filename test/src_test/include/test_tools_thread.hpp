@@ -0,0 +1,118 @@
+// Copyright © 2016-2020 Thomas Nagler and Thibault Vatter
+//
+// This file is part of the vinecopulib library and licensed under the terms of
+// the MIT license. For a copy, see the LICENSE file in the root directory of
+// vinecopulib or https://vinecopulib.github.io/vinecopulib/.
+
+#pragma once
+
+#include "gtest/gtest.h"
+#include <atomic>
+#include <numeric>
+#include <set>
+#include <vinecopulib/misc/tools_batch.hpp>
+#include <vinecopulib/misc/tools_stl.hpp>
+#include <vinecopulib/misc/tools_thread.hpp>
+
+namespace test_tools_thread {
+
+using namespace vinecopulib;
+
+TEST(test_tools_thread, map_runs_all_jobs)
+{
+  for (size_t num_threads : { 0, 1, 2, 4 }) {
+    std::vector<size_t> x(1000, 0);
+    tools_thread::ThreadPool pool(num_threads);
+    pool.map([&](size_t i) { x[i] = i; }, tools_stl::seq_int(0, 1000));
+    pool.wait();
+    EXPECT_EQ(x, tools_stl::seq_int(0, 1000));
+
+    // pools can be reused after waiting
+    pool.map([&](size_t i) { x[i] = 0; }, tools_stl::seq_int(0, 1000));
+    pool.join();
+    EXPECT_EQ(x, std::vector<size_t>(1000, 0));
+  }
+}
+
+TEST(test_tools_thread, exceptions_are_rethrown)
+{
+  tools_thread::ThreadPool pool(4);
+  pool.map(
+    [](size_t i) {
+      if (i == 50)
+        throw std::runtime_error("job failed");
+    },
+    tools_stl::seq_int(0, 100));
+  EXPECT_THROW(pool.wait(), std::runtime_error);
+
+  std::atomic<size_t> count{ 0 };
+  pool.map([&](size_t) { ++count; }, tools_stl::seq_int(0, 100));
+  EXPECT_NO_THROW(pool.wait());
+  EXPECT_EQ(count, 100);
+}
+
+TEST(test_tools_thread, nested_pools_share_workers)
+{
+  std::mutex m;
+  std::set<std::thread::id> ids;
+  std::atomic<size_t> count{ 0 };
+  auto inner = [&](size_t) {
+    {
+      std::lock_guard<std::mutex> lk(m);
+      ids.insert(std::this_thread::get_id());
+    }
+    ++count;
+  };
+  auto outer = [&](size_t) {
+    tools_thread::ThreadPool pool(4);
+    pool.map(inner, tools_stl::seq_int(0, 100));
+    pool.wait();
+  };
+  tools_thread::ThreadPool pool(4);
+  pool.map(outer, tools_stl::seq_int(0, 20));
+  pool.wait();
+
+  EXPECT_EQ(count, 2000);
+  // only the workers of the global pool and the main thread are used
+  EXPECT_LE(ids.size(), tools_thread::get_global_num_threads() + 1);
+  EXPECT_THROW(tools_thread::set_global_num_threads(2), std::runtime_error);
+}
+
+TEST(test_tools_thread, batches_cover_all_tasks)
+{
+  for (size_t num_threads : { 1, 4 }) {
+    for (size_t n : { 0, 1, 3, 100, 100000 }) {
+      auto batches = tools_batch::create_batches(n, num_threads);
+      size_t begin = 0;
+      for (auto& b : batches) {
+        EXPECT_EQ(b.begin, begin);
+        begin += b.size;
+      }
+      EXPECT_EQ(begin, n);
+      // batches get smaller towards the end
+      EXPECT_GE(batches.front().size, batches.back().size);
+    }
+  }
+}
+
+TEST(test_tools_thread, cost_batches_start_with_expensive_tasks)
+{
+  std::vector<double> costs(50, 1.0);
+  costs[10] = 100.0;
+  costs[30] = 50.0;
+  auto batches = tools_batch::create_batches(costs, 4);
+
+  // expensive tasks are run first and on their own
+  EXPECT_EQ(batches[0], std::vector<size_t>{ 10 });
+  EXPECT_EQ(batches[1], std::vector<size_t>{ 30 });
+  // every task is in exactly one batch
+  std::vector<size_t> tasks;
+  for (auto& batch : batches) {
+    tasks.insert(tasks.end(), batch.begin(), batch.end());
+  }
+  std::sort(tasks.begin(), tasks.end());
+  EXPECT_EQ(tasks, tools_stl::seq_int(0, 50));
+  // cheap tasks are grouped
+  EXPECT_LT(batches.size(), costs.size());
+}
+}
@@ -165,6 +165,71 @@ TEST_F(VinecopTest, pdf_is_correct)
   ASSERT_TRUE(vinecop.pdf(u).isApprox(f, 1e-4));
 }
 
+TEST_F(VinecopTest, logpdf_is_correct)
+{
+  auto pair_copulas = Vinecop::make_pair_copula_store(7, 3);
+  auto par = Eigen::VectorXd::Constant(1, 3.0);
+  for (auto& tree : pair_copulas) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 270, par);
+    }
+  }
+  Vinecop vinecop(model_matrix, pair_copulas);
+  Eigen::VectorXd log_f = f.array().log();
+  EXPECT_TRUE(vinecop.logpdf(u).isApprox(log_f, 1e-4));
+  EXPECT_NEAR(vinecop.loglik(u), vinecop.logpdf(u, 2).sum(), 1e-8);
+
+  // the log-density remains finite where the density overflows
+  size_t d = 500;
+  pair_copulas = Vinecop::make_pair_copula_store(d, 2);
+  for (auto& tree : pair_copulas) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::gumbel, 0, par);
+    }
+  }
+  vinecop = Vinecop(RVineStructure::simulate(d, false, { 1 }), pair_copulas);
+  auto x = vinecop.simulate(20, false, 1, { 2 });
+  EXPECT_TRUE(vinecop.logpdf(x).allFinite());
+  EXPECT_FALSE(vinecop.pdf(x).allFinite());
+}
+
+TEST_F(VinecopTest, chunked_pdf_is_correct)
+{
+  auto pair_copulas = Vinecop::make_pair_copula_store(7, 3);
+  auto par = Eigen::VectorXd::Constant(1, 3.0);
+  for (auto& tree : pair_copulas) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 270, par);
+    }
+  }
+  Vinecop vinecop(model_matrix, pair_copulas);
+
+  size_t chunk_size = 37;
+  size_t n = u.rows();
+  size_t begin = 0;
+  auto source = [&](Eigen::MatrixXd& chunk) {
+    if (begin >= n) {
+      return false;
+    }
+    size_t size = std::min(chunk_size, n - begin);
+    chunk = u.middleRows(begin, size);
+    begin += size;
+    return true;
+  };
+  Eigen::VectorXd pdf(n);
+  size_t pos = 0;
+  auto sink = [&](const Eigen::VectorXd& pdf_chunk) {
+    pdf.segment(pos, pdf_chunk.size()) = pdf_chunk;
+    pos += pdf_chunk.size();
+  };
+
+  vinecop.pdf_chunked(source, sink, 2);
+  EXPECT_EQ(pos, n);
+  EXPECT_TRUE(pdf.isApprox(f, 1e-4));
+  begin = 0;
+  EXPECT_NEAR(vinecop.loglik_chunked(source), vinecop.loglik(u), 1e-8);
+}
+
 TEST_F(VinecopTest, cdf_is_correct)
 {
   // Create a bivariate copula and a corresponding vine with two variables
@@ -189,6 +254,71 @@ TEST_F(VinecopTest, cdf_is_correct)
   vinecop.simulate(10, true);
 }
 
+TEST_F(VinecopTest, cdf_reuses_sample)
+{
+  auto pair_copulas = Vinecop::make_pair_copula_store(4);
+  for (auto& tree : pair_copulas) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::clayton, 0, Eigen::VectorXd::Constant(1, 2.0));
+    }
+  }
+  Vinecop vinecop(DVineStructure({ 1, 2, 3, 4 }), pair_copulas);
+  auto u_eval = tools_stats::simulate_uniform(200, 4, false, { 1 });
+  std::vector<int> seeds = { 1, 2, 3 };
+
+  // same result as counting dominated points in the simulated sample
+  auto u_sim = vinecop.simulate(1000, true, 1, seeds);
+  Eigen::VectorXd expected(200);
+  for (size_t i = 0; i < 200; ++i) {
+    auto dominated = (u_sim.rowwise() - u_eval.row(i)).array() <= 0.0;
+    expected(i) =
+      static_cast<double>(dominated.rowwise().all().count()) / 1000.0;
+  }
+  auto cdf = vinecop.cdf(u_eval, 1000, 1, seeds);
+  EXPECT_EQ(cdf, expected);
+  EXPECT_EQ(vinecop.cdf(u_eval, 1000, 3, seeds), cdf);
+
+  // the cached sample is discarded when the model changes
+  for (auto& tree : pair_copulas) {
+    for (auto& pc : tree) {
+      pc = Bicop(BicopFamily::indep);
+    }
+  }
+  vinecop.set_all_pair_copulas(pair_copulas);
+  auto cdf_indep = vinecop.cdf(u_eval, 1000, 1, seeds);
+  EXPECT_FALSE(cdf_indep.isApprox(cdf, 1e-2));
+  Eigen::VectorXd prod = u_eval.rowwise().prod();
+  EXPECT_LT((cdf_indep - prod).cwiseAbs().maxCoeff(), 0.05);
+}
+
+TEST_F(VinecopTest, cdf_adaptive_is_correct)
+{
+  auto pair_copulas = Vinecop::make_pair_copula_store(2);
+  auto par = Eigen::VectorXd::Constant(1, 0.5);
+  auto bicop = Bicop(BicopFamily::gaussian, 0, par);
+  pair_copulas[0][0] = bicop;
+  Vinecop vinecop(DVineStructure({ 1, 2 }), pair_copulas);
+  auto u_eval = vinecop.simulate(50, false, 1, { 1 });
+  u_eval(0, 1) = std::numeric_limits<double>::quiet_NaN();
+
+  auto cdf = vinecop.cdf_adaptive(u_eval, 1e-3, 0.0, 1e6, 2, { 1, 2 });
+  EXPECT_EQ(cdf.rows(), 50);
+  EXPECT_EQ(cdf.cols(), 2);
+  EXPECT_TRUE(cdf.row(0).array().isNaN().all());
+  auto exact = bicop.cdf(u_eval.bottomRows(49));
+  EXPECT_LE(cdf.col(1).tail(49).maxCoeff(), 1e-3);
+  EXPECT_LT((cdf.col(0).tail(49) - exact).cwiseAbs().maxCoeff(), 5e-3);
+
+  // reproducible with seeds, and independent of the number of threads
+  auto cdf1 = vinecop.cdf_adaptive(u_eval, 1e-3, 0.0, 1e6, 1, { 1, 2 });
+  EXPECT_EQ(cdf1.bottomRows(49), cdf.bottomRows(49));
+
+  // the sample size is bounded
+  auto cdf_small = vinecop.cdf_adaptive(u_eval, 0.0, 0.0, 1000, 1, { 1, 2 });
+  EXPECT_GT(cdf_small.col(1).tail(49).maxCoeff(), 0.0);
+  EXPECT_ANY_THROW(vinecop.cdf_adaptive(u_eval, -1.0));
+}
+
 TEST_F(VinecopTest, simulate_is_correct)
 {
   auto pair_copulas = Vinecop::make_pair_copula_store(7, 3);
@@ -251,6 +381,66 @@ TEST_F(VinecopTest, rosenblatt_is_correct)
     vinecop.rosenblatt(vinecop.inverse_rosenblatt(u)).isApprox(u, 1e-6));
 }
 
+TEST_F(VinecopTest, gaussian_vines_are_correct)
+{
+  // three-dimensional model with known correlation matrix
+  auto pair_copulas = Vinecop::make_pair_copula_store(3);
+  pair_copulas[0][0] =
+    Bicop(BicopFamily::gaussian, 0, Eigen::VectorXd::Constant(1, 0.5));
+  pair_copulas[0][1] =
+    Bicop(BicopFamily::gaussian, 0, Eigen::VectorXd::Constant(1, -0.3));
+  pair_copulas[1][0] =
+    Bicop(BicopFamily::gaussian, 0, Eigen::VectorXd::Constant(1, 0.7));
+  Eigen::Matrix<size_t, Eigen::Dynamic, Eigen::Dynamic> mat(3, 3);
+  mat << 2, 2, 2, 1, 1, 0, 3, 0, 0;
+  Vinecop vinecop(mat, pair_copulas);
+
+  // pairs (3, 2), (1, 2), and (3, 1) given 2
+  Eigen::Matrix3d sigma = Eigen::Matrix3d::Identity();
+  sigma(0, 1) = sigma(1, 0) = -0.3;
+  sigma(1, 2) = sigma(2, 1) = 0.5;
+  sigma(0, 2) = sigma(2, 0) = 0.7 * std::sqrt((1 - 0.09) * (1 - 0.25)) - 0.15;
+  auto v = tools_stats::simulate_uniform(100, 3, false, { 1 });
+  Eigen::MatrixXd z = tools_stats::qnorm(v);
+  Eigen::MatrixXd sigma_inv = sigma.inverse() - Eigen::Matrix3d::Identity();
+  Eigen::VectorXd f_mvn(100);
+  for (size_t i = 0; i < 100; ++i) {
+    f_mvn(i) = std::exp(-0.5 * z.row(i).dot(z.row(i) * sigma_inv)) /
+               std::sqrt(sigma.determinant());
+  }
+  EXPECT_TRUE(vinecop.pdf(v).isApprox(f_mvn, 1e-10));
+  EXPECT_TRUE(
+    vinecop.inverse_rosenblatt(vinecop.rosenblatt(v)).isApprox(v, 1e-8));
+
+  // truncated model (sparse): compare with pair-copulas of the first tree
+  size_t d = 20;
+  pair_copulas = Vinecop::make_pair_copula_store(d, 1);
+  for (size_t e = 0; e < d - 1; ++e) {
+    auto par =
+      Eigen::VectorXd::Constant(1, 0.8 - 0.08 * static_cast<double>(e));
+    pair_copulas[0][e] = (e % 5 == 0) ? Bicop(BicopFamily::indep)
+                                      : Bicop(BicopFamily::gaussian, 0, par);
+  }
+  auto structure = RVineStructure::simulate(d, false, { 2 });
+  structure.truncate(1);
+  vinecop = Vinecop(structure, pair_copulas);
+  v = tools_stats::simulate_uniform(100, d, false, { 3 });
+  Eigen::VectorXd pdf = Eigen::VectorXd::Ones(100);
+  Eigen::MatrixXd rosenblatt = v;
+  auto order = structure.get_order();
+  for (size_t e = 0; e < d - 1; ++e) {
+    Eigen::MatrixXd v_e(100, 2);
+    v_e.col(0) = v.col(order[e] - 1);
+    v_e.col(1) = v.col(structure.struct_array(0, e) - 1);
+    pdf = pdf.cwiseProduct(pair_copulas[0][e].pdf(v_e));
+    rosenblatt.col(order[e] - 1) = pair_copulas[0][e].hfunc2(v_e);
+  }
+  EXPECT_TRUE(vinecop.pdf(v).isApprox(pdf, 1e-10));
+  EXPECT_TRUE(vinecop.rosenblatt(v).isApprox(rosenblatt, 1e-10));
+  EXPECT_TRUE(
+    vinecop.inverse_rosenblatt(vinecop.rosenblatt(v)).isApprox(v, 1e-8));
+}
+
 TEST_F(VinecopTest, aic_bic_are_correct)
 {
   int d = 7;
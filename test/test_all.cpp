@@ -12,7 +12,9 @@
 #include "src_test/include/test_rvine_structure.hpp"
 #include "src_test/include/test_serialization.hpp"
 #include "src_test/include/test_tools_bobyqa.hpp"
+#include "src_test/include/test_tools_io.hpp"
 #include "src_test/include/test_tools_stats.hpp"
+#include "src_test/include/test_tools_thread.hpp"
 #include "src_test/include/test_vinecop_class.hpp"
 #include "src_test/include/test_vinecop_sanity_checks.hpp"
 #include "src_test/include/test_weights.hpp"
@@ -25,7 +27,9 @@ using namespace test_discrete;
 using namespace test_rvine_structure;
 using namespace test_serialization;
 using namespace test_tools_bobyqa;
+using namespace test_tools_io;
 using namespace test_tools_stats;
+using namespace test_tools_thread;
 using namespace test_vinecop_class;
 using namespace test_vinecop_sanity_checks;
 using namespace test_weights;